@@ -14,7 +14,28 @@ extern const std::array<Bitboard, 64> KNIGHT_TABLE;
 std::array<std::array<Bitboard, 64>, 2> generatePawnCaptureTable();
 extern const std::array<std::array<Bitboard, 64>, 2> PAWN_CAPTURE_TABLE;
 
-// Sliding and derived attacks (unchanged)
+// Squares strictly between two squares on a shared rank, file or diagonal
+// (0 when they are not aligned).
+std::array<std::array<Bitboard, 64>, 64> generateBetweenTable();
+extern const std::array<std::array<Bitboard, 64>, 64> BETWEEN_TABLE;
+
+// Sliding and derived attacks (unchanged). These go through the selected
+// slider backend; the ray walkers are kept as the reference implementation.
+// The default is Pext when it was compiled in (CHESS_USE_PEXT) and the CPU has
+// fast BMI2, otherwise Magic.
+enum class SliderBackend : std::uint8_t
+{
+    RayWalk,
+    Magic,
+    Pext
+};
+// Returns false (and keeps the current backend) if the request is unavailable.
+bool setSliderBackend(SliderBackend backend);
+SliderBackend sliderBackend();
+
+Bitboard computeRookMoveRay(int sq, Bitboard curr);
+Bitboard computeBishopMoveRay(int sq, Bitboard curr);
+
 Bitboard computeRookMove(int sq, Bitboard curr);
 Bitboard computeBishopMove(int sq, Bitboard curr);
 Bitboard computeQueenMove(int sq, Bitboard curr);
@@ -43,5 +64,10 @@ inline Bitboard computeQueenMoves(Color side, const Position &pos, int sq)
 
 Bitboard computePawnCapture(Color col, int sq);
 bool isPieceAttacked(int sq, Color opp, const Position &pos);
+// Every piece of either colour attacking sq, with sliders blocked by occ
+// rather than the board. Passing an occupancy with pieces lifted off lets
+// sliders behind them show up (x-rays); mask the result with occ to drop
+// the lifted pieces themselves.
+Bitboard attackersTo(int sq, Bitboard occ, const Position &pos);
 int kingSquare(Color side, const Position &pos);
 bool isKinginCheck(Color side, const Position &pos);
@@ -4,6 +4,10 @@
 #include <iostream>
 #include "chess/types.hpp"
 
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
 constexpr Bitboard FILE_A = 0x0101010101010101ULL;
 constexpr Bitboard FILE_H = 0x8080808080808080ULL;
 constexpr Bitboard FILE_B = 0x0202020202020202ULL;
@@ -34,6 +38,9 @@ inline Bitboard toggle_bit(Bitboard board, int index) { return board ^ convert_t
 
 inline int bits_set_count(Bitboard board)
 {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(board);
+#else
     int count = 0;
     while (board != 0)
     {
@@ -41,11 +48,19 @@ inline int bits_set_count(Bitboard board)
         count++;
     }
     return count;
+#endif
 }
 inline int peek_lsb(Bitboard board)
 {
     if (board == 0)
         return -1;
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(board);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long x;
+    _BitScanForward64(&x, board);
+    return static_cast<int>(x);
+#else
     int x = 0;
     while ((board & 1ULL) == 0ULL)
     {
@@ -53,6 +68,7 @@ inline int peek_lsb(Bitboard board)
         x++;
     }
     return x;
+#endif
 }
 inline int pop_lsb(Bitboard &board)
 {
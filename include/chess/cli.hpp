@@ -15,13 +15,13 @@
 
 static inline void wait_for_enter();
 
-inline std::string sq_to_str(int idx);
-inline char promo_char(uint8_t promo);
-inline std::string move_to_uci(const Move &m);
-inline const char *side_name(Color c);
-inline char piece_to_char(Piece p);
-inline std::string board_row_string(const Position &pos, int rank);
-inline void clear_screen();
+std::string sq_to_str(int idx);
+char promo_char(uint8_t promo);
+std::string move_to_uci(const Move &m);
+const char *side_name(Color c);
+char piece_to_char(Piece p);
+std::string board_row_string(const Position &pos, int rank);
+void clear_screen();
 
 void print_board(Bitboard board);
 void print_board_with_legal(const Position &pos,
@@ -0,0 +1,16 @@
+#pragma once
+
+// Instruction-set extensions the library can take advantage of at runtime.
+struct CpuFeatures
+{
+    bool bmi2 = false;
+    // PEXT is microcoded (and slow) on AMD before Zen 3, so BMI2 alone is not
+    // enough to prefer the PEXT slider backend.
+    bool fast_pext = false;
+    bool sse41 = false;
+    // AVX2 in the CPU and YMM state saved by the OS.
+    bool avx2 = false;
+};
+
+// Detected once via CPUID on first use.
+const CpuFeatures &cpuFeatures();
@@ -0,0 +1,21 @@
+#pragma once
+#include "chess/types.hpp"
+#include "chess/position.hpp"
+#include "chess/pawns.hpp"
+
+// Centipawn values indexed by Piece (EMPTY and the kings are 0). Used where a
+// single rough value per piece is wanted: SEE, capture ordering, delta
+// pruning. evaluate() uses the tapered tables in Psqt instead.
+constexpr int PIECE_VALUE[13] = {0, 100, 320, 330, 500, 900, 0, 100, 320, 330, 500, 900, 0};
+
+// Static evaluation in centipawns from the side to move's point of view:
+// the midgame and endgame piece-square sums plus pawn structure and king
+// shelter, blended by game phase. The piece-square sums and the phase are
+// maintained incrementally in the Position, so only the pawn terms cost
+// more than O(1), and with a PawnTable those come from the cache.
+int evaluate(const Position &pos, PawnTable &pawns);
+// Same without a cache: pawn terms are computed every call.
+int evaluate(const Position &pos);
+
+// The same score recomputed from the board, for tests and debug checks.
+int evaluateFromScratch(const Position &pos);
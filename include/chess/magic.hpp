@@ -0,0 +1,49 @@
+#pragma once
+#include <cstdint>
+#include "chess/types.hpp"
+
+// Fancy magic bitboards: each square owns a slice of one shared attack table,
+// indexed by ((occupancy & mask) * magic) >> shift.
+struct Magic
+{
+    Bitboard mask;
+    Bitboard magic;
+    Bitboard *attacks;
+    unsigned shift;
+
+    unsigned index(Bitboard occ) const
+    {
+        return static_cast<unsigned>(((occ & mask) * magic) >> shift);
+    }
+};
+
+// 4096 * 4 + 2048 * 12 + 1024 * 48 rook slots, 5248 bishop slots.
+constexpr int ROOK_TABLE_SIZE = 0x19000;
+constexpr int BISHOP_TABLE_SIZE = 0x1480;
+
+extern Magic ROOK_MAGICS[64];
+extern Magic BISHOP_MAGICS[64];
+
+// Builds masks, finds magics and fills the attack table. Runs once during
+// static initialisation of src/magic.cpp; calling it again is a no-op.
+bool initMagics();
+
+inline Bitboard magicRookAttacks(int sq, Bitboard occ)
+{
+    const Magic &m = ROOK_MAGICS[sq];
+    return m.attacks[m.index(occ)];
+}
+inline Bitboard magicBishopAttacks(int sq, Bitboard occ)
+{
+    const Magic &m = BISHOP_MAGICS[sq];
+    return m.attacks[m.index(occ)];
+}
+
+#ifdef CHESS_USE_PEXT
+// BMI2 backend: same masks and slice sizes as the magics, indexed with
+// _pext_u64(occ, mask) instead of a multiply. Its tables are only built when
+// the CPU reports BMI2, so check pextAvailable() before calling these.
+bool pextAvailable();
+Bitboard pextRookAttacks(int sq, Bitboard occ);
+Bitboard pextBishopAttacks(int sq, Bitboard occ);
+#endif
@@ -1,5 +1,6 @@
 #pragma once
-#include <stack>
+#include <cstddef>
+#include <vector>
 #include "chess/types.hpp"
 #include "chess/move.hpp"
 #include "chess/position.hpp"
@@ -7,7 +8,7 @@
 // From your code (unchanged)
 struct MoveHistory
 {
-    Move move;
+    PackedMove move;
     Piece moved_piece;
     Piece captured_piece;
     int captured;
@@ -15,9 +16,51 @@ struct MoveHistory
     uint8_t prev_castling;
     int prev_halfmove;
     int prev_fullmove;
+    std::uint64_t prev_zobrist;
+    std::uint64_t prev_pawn_key;
 };
 
-extern std::stack<MoveHistory> history;
+// Undo records plus the Zobrist keys used for repetition detection, for one
+// game or one search thread. keys[0] is the root position and every makeMove
+// pushes one of each. Both buffers are reserved up front, so make/undo do not
+// allocate unless a line outgrows the initial capacity.
+struct StateStack
+{
+    std::vector<MoveHistory> moves;
+    std::vector<std::uint64_t> keys;
+
+    explicit StateStack(std::size_t capacity = 1024)
+    {
+        moves.reserve(capacity);
+        keys.reserve(capacity + 1);
+    }
+
+    // Drops all history and makes pos the new root.
+    void reset(const Position &pos)
+    {
+        moves.clear();
+        keys.clear();
+        keys.push_back(pos.zobrist);
+    }
+};
+
+void makeMove(Position &pos, const Move &move, StateStack &state);
+void UndoMove(Position &pos, StateStack &state);
+
+// Passes the turn (null-move pruning): clears en passant and flips the side
+// to move, key included, and pushes a record with no move onto state.
+// halfmove restarts at 0 so repetition checks never reach across the null
+// move. Undo with undoNullMove, not UndoMove.
+void makeNullMove(Position &pos, StateStack &state);
+void undoNullMove(Position &pos, StateStack &state);
+
+// The calling thread's own stack, used by the two-argument shims below and
+// by rep_init (start_position/loadFEN). Each thread gets a separate one.
+StateStack &defaultStateStack();
 
 void makeMove(Position &pos, const Move &move);
 void UndoMove(Position &pos);
+
+// Copy-make: returns the position after move and leaves pos untouched. No
+// undo record or repetition key is kept, so there is nothing to unmake.
+Position makeMoveCopy(const Position &pos, const Move &move);
@@ -1,4 +1,6 @@
 #pragma once
+#include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include "chess/types.hpp"
 
@@ -18,3 +20,126 @@ inline bool operator==(const Move &a, const Move &b)
            a.flags == b.flags &&
            a.promo == b.promo;
 }
+
+// 16-bit move: bits 0-5 from, 6-11 to, 12-15 kind. The kind folds the flag
+// combinations the generators emit together with the promotion piece, so the
+// conversion to and from Move is lossless for every generated move (Move's
+// captured field is always -1 there). All-zero data means "no move".
+struct PackedMove
+{
+    uint16_t data = 0;
+
+    int from() const { return data & 0x3F; }
+    int to() const { return (data >> 6) & 0x3F; }
+    int kind() const { return data >> 12; }
+    bool isNone() const { return data == 0; }
+};
+
+enum PackedKind : uint16_t
+{
+    KIND_QUIET = 0,
+    KIND_DOUBLE_PUSH = 1,
+    KIND_CAPTURE = 2,
+    KIND_EN_PASSANT = 3,
+    KIND_PROMO = 4,         // + (promo - PROMO_N)
+    KIND_PROMO_CAPTURE = 8, // + (promo - PROMO_N)
+};
+
+inline bool operator==(PackedMove a, PackedMove b) { return a.data == b.data; }
+inline bool operator!=(PackedMove a, PackedMove b) { return a.data != b.data; }
+
+inline PackedMove packMove(const Move &m)
+{
+    assert(m.from >= 0 && m.from < 64 && m.to >= 0 && m.to < 64);
+    uint16_t kind = KIND_QUIET;
+    if (m.flags & PROMOTION)
+        kind = ((m.flags & CAPTURE) ? KIND_PROMO_CAPTURE : KIND_PROMO) + (m.promo - PROMO_N);
+    else if (m.flags & EN_PASSANT)
+        kind = KIND_EN_PASSANT;
+    else if (m.flags & CAPTURE)
+        kind = KIND_CAPTURE;
+    else if (m.flags & DOUBLE_PUSH)
+        kind = KIND_DOUBLE_PUSH;
+    PackedMove p;
+    p.data = static_cast<uint16_t>(m.from | (m.to << 6) | (kind << 12));
+    return p;
+}
+
+inline Move unpackMove(PackedMove p)
+{
+    static const uint16_t kind_flags[4] = {0, DOUBLE_PUSH, CAPTURE, EN_PASSANT};
+    Move m{p.from(), p.to(), 0, NO_PROMO, -1};
+    int kind = p.kind();
+    if (kind >= KIND_PROMO_CAPTURE)
+    {
+        m.flags = CAPTURE | PROMOTION;
+        m.promo = static_cast<uint8_t>(PROMO_N + kind - KIND_PROMO_CAPTURE);
+    }
+    else if (kind >= KIND_PROMO)
+    {
+        m.flags = PROMOTION;
+        m.promo = static_cast<uint8_t>(PROMO_N + kind - KIND_PROMO);
+    }
+    else
+    {
+        m.flags = kind_flags[kind];
+    }
+    return m;
+}
+
+// Fixed-capacity move buffer that lives inline (on the stack). No reachable
+// position has more than 218 legal moves, so 256 is never exceeded.
+struct MoveList
+{
+    static constexpr int CAPACITY = 256;
+
+    Move moves[CAPACITY];
+    int count = 0;
+
+    void push_back(const Move &m)
+    {
+        assert(count < CAPACITY && "MoveList overflow");
+        moves[count++] = m;
+    }
+    void clear() { count = 0; }
+    bool empty() const { return count == 0; }
+    std::size_t size() const { return static_cast<std::size_t>(count); }
+
+    Move &operator[](int i) { return moves[i]; }
+    const Move &operator[](int i) const { return moves[i]; }
+    Move *begin() { return moves; }
+    Move *end() { return moves + count; }
+    const Move *begin() const { return moves; }
+    const Move *end() const { return moves + count; }
+};
+
+// MoveList counterpart holding packed moves: 512 bytes instead of 4 KiB, so
+// generation and sorting touch eight times fewer cache lines.
+struct PackedMoveList
+{
+    static constexpr int CAPACITY = 256;
+
+    PackedMove moves[CAPACITY];
+    int count = 0;
+
+    void push_back(const Move &m)
+    {
+        assert(count < CAPACITY && "PackedMoveList overflow");
+        moves[count++] = packMove(m);
+    }
+    void push_back(PackedMove m)
+    {
+        assert(count < CAPACITY && "PackedMoveList overflow");
+        moves[count++] = m;
+    }
+    void clear() { count = 0; }
+    bool empty() const { return count == 0; }
+    std::size_t size() const { return static_cast<std::size_t>(count); }
+
+    PackedMove &operator[](int i) { return moves[i]; }
+    const PackedMove &operator[](int i) const { return moves[i]; }
+    PackedMove *begin() { return moves; }
+    PackedMove *end() { return moves + count; }
+    const PackedMove *begin() const { return moves; }
+    const PackedMove *end() const { return moves + count; }
+};
@@ -91,3 +91,37 @@ void generateRookMoves(const Position &pos, std::vector<Move> &list);
 void generateQueenMoves(const Position &pos, std::vector<Move> &list);
 void generateAllMoves(const Position &pos, std::vector<Move> &list);
 void generateLegalAllMoves(Position &pos, std::vector<Move> &final);
+
+// Fully legal generation: checkers, pins and the check-evasion mask are
+// computed once per node, so no move is made and unmade to test it.
+// generateLegalAllMoves forwards here.
+void generateLegalMoves(const Position &pos, std::vector<Move> &list);
+// The previous pseudo-legal + makeMove/isKinginCheck/UndoMove filter, kept
+// as a reference for tests and benchmarks.
+void generateLegalAllMovesMakeUndo(Position &pos, std::vector<Move> &final);
+
+// Same generators writing into a stack MoveList, so perft and search never
+// touch the heap. The std::vector versions stay for the GUI and CLI.
+void generatePawnMoves(const Position &pos, MoveList &list);
+void generateKnightMoves(const Position &pos, MoveList &list);
+void generateKingMoves(const Position &pos, MoveList &list);
+void generateBishopMoves(const Position &pos, MoveList &list);
+void generateRookMoves(const Position &pos, MoveList &list);
+void generateQueenMoves(const Position &pos, MoveList &list);
+void generateAllMoves(const Position &pos, MoveList &list);
+void generateLegalMoves(const Position &pos, MoveList &list);
+void generateLegalAllMoves(Position &pos, MoveList &final);
+// The legal moves split in two: captures, en passant and every promotion
+// (quiet promotions included), then everything else. Together they give
+// exactly generateLegalMoves, in a different order.
+void generateLegalCaptures(const Position &pos, MoveList &list);
+void generateLegalQuiets(const Position &pos, MoveList &list);
+// Whether move is legal here, generating only the moves of the piece on its
+// from square. For moves that come from outside the generator (the
+// transposition table, killer slots), which may belong to another position.
+bool isLegalMove(const Position &pos, PackedMove move);
+// Whether the side to move has any legal move at all, stopping at the first
+// one found instead of generating the list. For mate/stalemate detection.
+bool hasLegalMove(const Position &pos);
+void generateAllMoves(const Position &pos, PackedMoveList &list);
+void generateLegalMoves(const Position &pos, PackedMoveList &list);
@@ -0,0 +1,91 @@
+#pragma once
+#include "chess/types.hpp"
+#include "chess/move.hpp"
+#include "chess/position.hpp"
+
+// Butterfly history: a score per side and from/to pair for quiet moves,
+// raised when the move causes a beta cutoff and lowered when a later quiet
+// does instead. The gravity update keeps every entry within [-MAX, MAX].
+struct HistoryTable
+{
+    static constexpr int MAX = 1 << 14;
+
+    int table[2][64][64] = {};
+
+    int get(Color side, PackedMove m) const { return table[side][m.from()][m.to()]; }
+    void update(Color side, PackedMove m, int bonus)
+    {
+        int &h = table[side][m.from()][m.to()];
+        int clamped = bonus > MAX ? MAX : bonus < -MAX ? -MAX : bonus;
+        h += clamped - h * (clamped < 0 ? -clamped : clamped) / MAX;
+    }
+    void clear() { *this = HistoryTable{}; }
+};
+
+// Hands out the legal moves of a position one at a time, best guess first,
+// generating each batch only when the previous one has run out, so a cutoff
+// on the TT move or a capture never pays for quiet move generation.
+//
+// Main search order: the first move (TT or PV move), captures that do not
+// lose material by MVV-LVA, the two killers, quiets by history, then the
+// losing captures. A capture's SEE is only computed when it is its turn.
+class MovePicker
+{
+public:
+    enum Stage
+    {
+        STAGE_FIRST,
+        STAGE_INIT_CAPTURES,
+        STAGE_GOOD_CAPTURES,
+        STAGE_KILLERS,
+        STAGE_INIT_QUIETS,
+        STAGE_QUIETS,
+        STAGE_BAD_CAPTURES,
+        STAGE_QS_INIT,
+        STAGE_QS_CAPTURES,
+        STAGE_UNORDERED_INIT,
+        STAGE_UNORDERED,
+        STAGE_DONE
+    };
+
+    // first and the killers may be none or illegal here; they are checked
+    // before being returned. killers may be null.
+    MovePicker(const Position &pos, PackedMove first, const PackedMove *killers, const HistoryTable &history);
+    // Quiescence: captures and queen promotions by MVV-LVA, leaving out
+    // those that lose material in the exchange. Quiet underpromotions are
+    // for the main search only.
+    explicit MovePicker(const Position &pos);
+    // Every legal move in plain generation order, for comparisons.
+    struct Unordered
+    {
+    };
+    MovePicker(const Position &pos, Unordered);
+
+    // False once every move has been returned.
+    bool next(Move &out);
+    // Stage the last move returned by next() came from.
+    Stage lastStage() const { return last_stage; }
+
+private:
+    void scoreCaptures(int begin, int end);
+    void scoreQuiets(int begin, int end);
+    void pickBest(int begin, int end);
+    bool isSpecial(PackedMove m) const;
+
+    const Position &pos;
+    const HistoryTable *history = nullptr;
+    PackedMove first;
+    PackedMove killers[2];
+    int killer_index = 0;
+    Stage stage;
+    Stage last_stage = STAGE_DONE;
+
+    // One list for everything: captures from 0, with the losing ones swapped
+    // down into [0, bad_end) as they are found, then quiets appended after.
+    MoveList moves;
+    int scores[MoveList::CAPACITY];
+    int cur = 0;
+    int end = 0;
+    int bad_end = 0;
+    int bad_cur = 0;
+};
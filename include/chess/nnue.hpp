@@ -0,0 +1,136 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "chess/types.hpp"
+#include "chess/position.hpp"
+
+// Efficiently updatable neural-network evaluation.
+//
+// Inputs are HalfKA-style: for each perspective (white, black) there is one
+// feature per piece and square, seen from that side (the board flipped for
+// black, "ours" before "theirs"), in one of KING_BUCKETS sets picked by
+// where that side's own king stands. The first layer sums the weight rows
+// of the active features into ACC_SIZE int16 values per perspective. A move
+// switches only a few features, so the search keeps one of these
+// accumulators per ply and derives each from the ply before. Two small
+// dense layers turn the side to move's half and the other half into a
+// score.
+namespace Nnue
+{
+
+constexpr int KING_BUCKETS = 4;
+constexpr int FEATURES = KING_BUCKETS * 12 * 64;
+constexpr int ACC_SIZE = 32;    // accumulator width per perspective
+constexpr int HIDDEN_SIZE = 16; // second layer
+// Activations are clipped to [0, ACT_MAX]; the hidden layer's sums are
+// shifted down by HIDDEN_SHIFT first and the output divided by
+// OUTPUT_SCALE to get centipawns.
+constexpr int ACT_MAX = 127;
+constexpr int HIDDEN_SHIFT = 6;
+constexpr int OUTPUT_SCALE = 16;
+
+// A network file, little-endian throughout:
+//
+//   char[4]  "CNUE"
+//   uint32   version (1), FEATURES, ACC_SIZE, HIDDEN_SIZE
+//   then, each section starting on a 64-byte boundary:
+//   int16    feature bias[ACC_SIZE]
+//   int16    feature weights[FEATURES][ACC_SIZE]
+//   int32    hidden bias[HIDDEN_SIZE]
+//   int8     hidden weights[HIDDEN_SIZE][2 * ACC_SIZE], side to move's half first
+//   int32    output bias
+//   int8     output weights[HIDDEN_SIZE]
+//
+// The file is memory-mapped and the weights are read in place, so loading
+// costs no copy and processes using the same net share its pages.
+class Network
+{
+public:
+    Network() = default;
+    ~Network();
+    Network(const Network &) = delete;
+    Network &operator=(const Network &) = delete;
+
+    // Maps the file at path and checks its header and size. On failure the
+    // network is left empty and error (when given) says why.
+    bool load(const std::string &path, std::string *error = nullptr);
+    bool loaded() const { return ft_weights != nullptr; }
+    // Releases the file; loaded() is false afterwards.
+    void unload();
+
+    const std::int16_t *ft_bias = nullptr;
+    const std::int16_t *ft_weights = nullptr;
+    const std::int32_t *hidden_bias = nullptr;
+    const std::int8_t *hidden_weights = nullptr;
+    std::int32_t output_bias = 0;
+    const std::int8_t *output_weights = nullptr;
+
+private:
+    void *map = nullptr;
+    std::size_t map_size = 0;
+};
+
+// Feature set, 0 .. KING_BUCKETS - 1, for a king on king_sq as seen by side.
+int kingBucket(Color side, int king_sq);
+// Feature index of piece p on sq for perspective side with its king in bucket.
+int featureIndex(Color side, int bucket, Piece p, int sq);
+
+struct Accumulator
+{
+    alignas(64) std::int16_t values[2][ACC_SIZE]; // by perspective
+    bool computed[2] = {false, false};
+    std::int8_t bucket[2] = {0, 0};
+    DirtyPieces dirty; // what the move into this ply changed
+};
+
+// Sums the feature rows of every piece on pos for side into acc.
+void refresh(const Network &net, const Position &pos, Color side, Accumulator &acc);
+
+// Kernels for the dense layers and the accumulator updates. Scalar always
+// works; the others only where the CPU has them (see available()). All give
+// identical results.
+enum class Simd
+{
+    Scalar,
+    Sse41,
+    Avx2
+};
+
+bool available(Simd simd);
+// The fastest available, picked once via cpuFeatures().
+Simd bestSimd();
+
+// The dense layers on top of acc, in centipawns for stm.
+int forward(const Network &net, const Accumulator &acc, Color stm, Simd simd = bestSimd());
+
+// One Accumulator per ply of a search. reset() fills the root from the
+// board; after each move, push() stores what changed, and evaluate() brings
+// the entry up to date from the nearest computed ply below it, or from the
+// board when the king of that perspective changed bucket on the way.
+class AccumulatorStack
+{
+public:
+    AccumulatorStack(const Network &net, int plies);
+
+    void reset(const Position &pos);
+    // pos has just been reached at ply, by a move or a null move from ply - 1.
+    void push(int ply, const Position &pos);
+    // Static evaluation of pos, the position at ply, for the side to move.
+    int evaluate(int ply, const Position &pos);
+
+    const Accumulator &at(int ply) const { return entries[ply]; }
+
+private:
+    void update(int ply, const Position &pos, Color side);
+
+    const Network &net;
+    std::vector<Accumulator> entries;
+};
+
+// Evaluation with an accumulator built from scratch, for tests and for use
+// outside a search.
+int evaluate(const Network &net, const Position &pos);
+
+} // namespace Nnue
@@ -0,0 +1,75 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "chess/types.hpp"
+#include "chess/position.hpp"
+
+// Pawn-structure evaluation: doubled, isolated, backward and passed pawns,
+// white minus black, plus the passed pawns themselves for the terms that
+// also depend on pieces. A function of the pawns alone, so it is cached by
+// Position::pawn_key.
+struct PawnEntry
+{
+    Bitboard passed[2] = {0, 0};
+    // The key's upper half. The table indexes by the low bits, so together
+    // they tell structures apart, and the entry stays at 32 bytes.
+    std::uint32_t check = 0;
+    std::int16_t mg = 0;
+    std::int16_t eg = 0;
+    // King shelter also depends on the king square, so each side's value is
+    // cached together with the square it was computed for (-1: none yet).
+    std::int16_t shelter[2] = {0, 0};
+    std::int8_t shelter_king[2] = {-1, -1};
+
+    static std::uint32_t checkOf(std::uint64_t pawn_key) { return static_cast<std::uint32_t>(pawn_key >> 32); }
+};
+static_assert(sizeof(PawnEntry) == 32, "PawnEntry should fill half a cache line");
+
+// Fills e (check included) from scratch.
+void evaluatePawns(const Position &pos, PawnEntry &e);
+
+// Midgame bonus for the pawns in front of side's king.
+int kingShelter(const Position &pos, Color side);
+
+// Two-way set-associative cache of PawnEntry, least recently used out.
+// Pawn structures repeat so much within a search, and from one move's
+// search to the next, that a small table hits almost every time. Not
+// shared: each search thread uses one of its own, from PawnTables.
+class PawnTable
+{
+public:
+    explicit PawnTable(std::size_t kb = 2048);
+
+    void clear();
+    // The entry for pos's pawns, computed on a miss.
+    PawnEntry &probe(const Position &pos);
+
+    std::uint64_t probes() const { return probe_count; }
+    std::uint64_t hits() const { return hit_count; }
+
+private:
+    std::vector<PawnEntry> entries;
+    std::uint64_t mask = 0;
+    std::uint64_t probe_count = 0;
+    std::uint64_t hit_count = 0;
+};
+
+// One PawnTable per search thread, thread(0) for the main thread. Like the
+// transposition table it belongs to the caller and outlives a search, so
+// the next search starts with what the last one cached. Entries depend on
+// the pawns alone and never go stale.
+class PawnTables
+{
+public:
+    // The table for search thread i, allocated on first use.
+    PawnTable &thread(std::size_t i);
+    void clear();
+
+private:
+    std::vector<std::unique_ptr<PawnTable>> tables;
+};
+
+// The calling thread's PawnTables, for searches that are not given any.
+PawnTables &defaultPawnTables();
@@ -0,0 +1,108 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "chess/types.hpp"
+#include "chess/position.hpp"
+#include "chess/make_undo.hpp"
+
+// Leaf-node counts for move generator validation and benchmarking.
+
+// make/undo on pos, using state for the undo records.
+std::uint64_t perft(Position &pos, StateStack &state, int depth);
+// Same, on the calling thread's default stack.
+std::uint64_t perft(Position &pos, int depth);
+// Copy-make: every child is a fresh copy from makeMoveCopy.
+std::uint64_t perftCopy(const Position &pos, int depth);
+
+// Shared (key, depth) -> node count cache for deep perft runs. Lock-free:
+// each entry stores key ^ data next to data, so a torn write from another
+// thread fails the key check and is treated as a miss. With verify set, a
+// second 64-bit signature built from the bitboards is stored as
+// signature ^ data and must match too, which makes a false hit from a
+// Zobrist collision practically impossible and lets us count the
+// collisions it catches. The lock then covers that word as well, so a
+// write torn between data and check is still a plain miss, never counted
+// as a collision.
+struct PerftHashStats
+{
+    std::uint64_t probes = 0;
+    std::uint64_t hits = 0;
+    std::uint64_t collisions = 0; // key matched, signature did not (verify only)
+    std::uint64_t stores = 0;
+
+    void add(const PerftHashStats &o)
+    {
+        probes += o.probes;
+        hits += o.hits;
+        collisions += o.collisions;
+        stores += o.stores;
+    }
+};
+
+class PerftTable
+{
+public:
+    explicit PerftTable(std::size_t mb = 16, bool verify = false);
+
+    // Reallocates to the largest power-of-two bucket count that fits in mb
+    // megabytes and clears the table. Not safe while other threads use it.
+    void resize(std::size_t mb);
+    void clear();
+    bool verifying() const { return verify_; }
+    std::size_t sizeBytes() const { return buckets_count_ * sizeof(Bucket); }
+
+    bool probe(const Position &pos, int depth, std::uint64_t &nodes, PerftHashStats &stats) const;
+    void store(const Position &pos, int depth, std::uint64_t nodes, PerftHashStats &stats);
+
+private:
+    struct Entry
+    {
+        std::atomic<std::uint64_t> lock{0};  // key ^ data ^ check
+        std::atomic<std::uint64_t> data{0};  // nodes << 8 | depth
+        std::atomic<std::uint64_t> check{0}; // signature ^ data, verify mode only (else 0)
+    };
+    // Slot 0 keeps the deepest subtree seen, slot 1 always takes the newest.
+    struct Bucket
+    {
+        Entry slots[2];
+    };
+
+    std::unique_ptr<Bucket[]> buckets_;
+    std::size_t buckets_count_ = 0;
+    bool verify_;
+};
+
+// make/undo perft that looks up and stores every subtree of depth >= 2.
+std::uint64_t perftHashed(Position &pos, StateStack &state, int depth, PerftTable &table, PerftHashStats &stats);
+
+// Parallel perft. The tree is expanded with copy-make down to a split ply
+// until there are enough subtrees to keep every thread busy; the subtrees
+// are dealt round-robin onto per-thread deques. A worker takes from the
+// front of its own deque and steals from the back of the others' when it
+// runs dry. Each worker searches on its own Position and StateStack.
+struct PerftThreadStats
+{
+    std::uint64_t nodes = 0;
+    std::uint64_t tasks = 0;  // subtrees searched, including stolen ones
+    std::uint64_t steals = 0; // subtrees taken from another thread's deque
+    double busy_seconds = 0;  // time spent inside subtree searches
+    PerftHashStats hash;      // only filled in when a table is shared
+};
+
+struct ParallelPerftResult
+{
+    std::uint64_t nodes = 0;
+    double seconds = 0;
+    int split_ply = 0;
+    std::uint64_t tasks = 0;
+    std::vector<PerftThreadStats> threads;
+};
+
+// threads <= 0 uses std::thread::hardware_concurrency(). split_ply <= 0
+// picks the shallowest ply that yields at least 16 subtrees per thread.
+// With a table, all workers share it through perftHashed.
+ParallelPerftResult perftParallel(const Position &pos, int depth, int threads, int split_ply = 0,
+                                  PerftTable *table = nullptr);
@@ -3,8 +3,36 @@
 #include "chess/bitboard.hpp"
 #include "chess/zobrist.hpp"
 #include "chess/repetition.hpp"
+#include "chess/psqt.hpp"
 
+// The piece placements changed since the last makeMove, UndoMove or null
+// move began, in order: what an NNUE accumulator (nnue.hpp) needs to follow
+// a move without rescanning the board. addPiece/removePiece append. A move
+// changes at most MAX placements (castling); anything past that, as when a
+// board is set up piece by piece, only bumps count, which tells the reader
+// to recompute from the board instead.
+struct DirtyPieces
+{
+    static constexpr int MAX = 4;
+
+    struct Change
+    {
+        Piece piece;
+        std::int8_t sq;
+        bool added;
+    };
 
+    Change changes[MAX];
+    int count = 0;
+
+    void clear() { count = 0; }
+    void record(Piece piece, int sq, bool added)
+    {
+        if (count < MAX)
+            changes[count] = Change{piece, static_cast<std::int8_t>(sq), added};
+        count++;
+    }
+};
 
 struct Position
 {
@@ -12,28 +40,54 @@ struct Position
     Bitboard p = 0, n = 0, b = 0, r = 0, q = 0, k = 0; // Black
 
     Bitboard white_pieces = 0, black_pieces = 0, total_pieces = 0;
+    // Mailbox kept in sync with the bitboards by addPiece/removePiece, so
+    // "what is on this square" is a single load.
+    Piece board[64] = {};
     Color side_to_move = WHITE;
     std::uint8_t castling = 0;
     std::uint64_t zobrist = 0;
+    std::uint64_t pawn_key = 0; // Zobrist::computePawnKey, kept up to date by makeMove
     int en_passant = -1;
     int halfmove = 0;
     int fullmove = 0;
+    // Tapered eval terms (Psqt), white minus black, kept up to date by
+    // addPiece/removePiece so UndoMove restores them along with the pieces.
+    int psq_mg = 0;
+    int psq_eg = 0;
+    int phase = 0;
+    DirtyPieces dirty;
     void board_state()
     {
         white_pieces = P | N | B | R | Q | K;
         black_pieces = p | n | b | r | q | k;
         total_pieces = white_pieces | black_pieces;
     }
+    void fill_mailbox()
+    {
+        const Bitboard *boards[12] = {&P, &N, &B, &R, &Q, &K, &p, &n, &b, &r, &q, &k};
+        for (Piece &sq : board)
+            sq = EMPTY;
+        for (int i = 0; i < 12; i++)
+        {
+            Bitboard x = *boards[i];
+            while (x)
+                board[pop_lsb(x)] = static_cast<Piece>(WP + i);
+        }
+    }
     void clear()
     {
         P = N = B = R = Q = K = 0;
         p = n = b = r = q = k = 0;
         white_pieces = black_pieces = total_pieces = 0;
+        for (Piece &sq : board)
+            sq = EMPTY;
         side_to_move = WHITE;
         castling = 0;
         en_passant = -1;
         halfmove = 0;
         fullmove = 0;
+        psq_mg = psq_eg = phase = 0;
+        dirty.clear();
     }
 
     void start_position()
@@ -64,8 +118,11 @@ struct Position
         fullmove = 1;
 
         board_state();
+        fill_mailbox();
+        Psqt::compute(*this, psq_mg, psq_eg, phase);
         Zobrist::init();
         zobrist = Zobrist::compute(*this);
+        pawn_key = Zobrist::computePawnKey(*this);
         rep_init(*this);
 
     }
@@ -78,3 +135,7 @@ Piece getPiece(const Position &pos, int sq);
 Piece removePiece(Position &pos, int sq);
 void addPiece(Position &pos, int sq, Piece p);
 void print_pos_board(const Position &pos);
+
+// True when the mailbox, the piece bitboards and the colour/total aggregates
+// all describe the same board. Meant for tests and debug assertions.
+bool positionConsistent(const Position &pos);
@@ -0,0 +1,28 @@
+#pragma once
+#include "chess/types.hpp"
+
+struct Position;
+
+// Tapered piece-square tables (PeSTO values) with material folded in.
+// Indexed by Piece and square, signed from white's point of view: black
+// entries are negative, so a position's score is a plain sum.
+namespace Psqt {
+
+struct Tables
+{
+    int mg[13][64];
+    int eg[13][64];
+};
+
+extern const Tables TABLES;
+
+// Game-phase weight per Piece. MAX_PHASE with every minor and major piece
+// on the board, 0 with only kings and pawns.
+constexpr int PHASE[13] = {0, 0, 1, 1, 2, 4, 0, 0, 1, 1, 2, 4, 0};
+constexpr int MAX_PHASE = 24;
+
+// Midgame sum, endgame sum and phase from scratch. Used to initialise a
+// position and to check the incremental values.
+void compute(const Position &pos, int &mg, int &eg, int &phase);
+
+} // namespace Psqt
@@ -3,8 +3,10 @@
 #include <vector>
 
 struct Position;                 // forward-declare
+struct StateStack;
 
-extern std::vector<std::uint64_t> g_rep_stack;
+// Repetition queries over a StateStack's key history. The overloads without a
+// StateStack use the calling thread's defaultStateStack().
 
 void rep_init(const Position& pos);
 
@@ -13,5 +15,7 @@ void rep_push(const Position& pos);
 void rep_pop();
 
 int  rep_count_current(const Position& pos, int max_plies_window);
+int  rep_count_current(const Position& pos, int max_plies_window, const StateStack& state);
 
 bool is_threefold(const Position& pos);
+bool is_threefold(const Position& pos, const StateStack& state);
@@ -0,0 +1,132 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "chess/types.hpp"
+#include "chess/move.hpp"
+#include "chess/position.hpp"
+#include "chess/make_undo.hpp"
+#include "chess/tt.hpp"
+#include "chess/pawns.hpp"
+#include "chess/nnue.hpp"
+#include "chess/timeman.hpp"
+
+constexpr int MAX_PLY = 128;
+constexpr int INF_SCORE = 32000;
+// Mate at ply n scores MATE_SCORE - n for the side delivering it; anything
+// beyond MATE_BOUND is a forced mate.
+constexpr int MATE_SCORE = 31000;
+constexpr int MATE_BOUND = MATE_SCORE - MAX_PLY;
+
+inline bool isMateScore(int score)
+{
+    return score >= MATE_BOUND || score <= -MATE_BOUND;
+}
+
+struct SearchLimits
+{
+    int depth = MAX_PLY - 1;
+    std::uint64_t nodes = 0;      // 0 = no node limit, else all threads together
+    std::int64_t movetime_ms = 0; // 0 = no time limit
+    int threads = 1;              // Lazy SMP: the main thread plus threads - 1 helpers
+    // Raised by another thread (a UCI "stop") to end the search early; the
+    // result is that of the last finished iteration, as with the limits.
+    const std::atomic<bool> *stop = nullptr;
+    // Clock-based deadlines, started by the caller. The hard limit is
+    // checked with the node and time limits; the main thread reports every
+    // iteration and root fail low to it and stops where it says.
+    TimeManager *time = nullptr;
+    bool move_ordering = true;    // false: main search takes moves in generation order (benchmarks)
+    // Evaluate with this network instead of the hand-written evaluate().
+    // Not owned; must stay loaded for the whole search.
+    const Nnue::Network *network = nullptr;
+
+    // Selectivity, all on by default. Switching one off gives the plain
+    // alpha-beta behaviour for that part, for benchmarks and debugging.
+    bool null_move = true;        // null-move pruning
+    bool lmr = true;              // late-move reductions
+    bool futility = true;         // skip quiet moves near the leaves when far below alpha
+    bool reverse_futility = true; // return the static eval near the leaves when far above beta
+    bool aspiration = true;       // narrow root window around the previous iteration's score
+};
+
+// One finished iteration of iterative deepening. Nodes and seconds are
+// totals since the search started; depth_seconds is this iteration alone.
+struct SearchIteration
+{
+    int depth = 0;
+    int score = 0;
+    std::uint64_t nodes = 0;
+    double seconds = 0;
+    double depth_seconds = 0;
+    std::vector<Move> pv;
+};
+
+struct SearchResult
+{
+    Move best_move{};
+    bool has_move = false; // false when the root is already mate, stalemate or a draw
+    int score = 0;
+    int depth = 0;         // deepest finished iteration
+    std::uint64_t nodes = 0;
+    double seconds = 0;
+    bool stopped = false;  // a node or time limit cut the last iteration short
+    std::uint64_t qnodes = 0; // part of nodes spent in quiescence
+    std::uint64_t tt_probes = 0;
+    std::uint64_t tt_hits = 0;
+    int hashfull = 0;      // per mille of the table written by this search
+    std::uint64_t beta_cutoffs = 0;       // main search, quiescence not counted
+    std::uint64_t first_move_cutoffs = 0; // part of beta_cutoffs made by the first move tried
+    std::uint64_t pawn_probes = 0;        // pawn hash, every thread's own table, this search only
+    std::uint64_t pawn_hits = 0;
+    std::vector<std::uint64_t> thread_nodes; // [0] is the main thread
+    std::vector<Move> pv;
+    std::vector<SearchIteration> iterations;
+
+    std::uint64_t nps() const
+    {
+        return seconds > 0 ? static_cast<std::uint64_t>(nodes / seconds) : 0;
+    }
+    double qnodeShare() const
+    {
+        return nodes ? static_cast<double>(qnodes) / nodes : 0.0;
+    }
+    double ttHitRate() const
+    {
+        return tt_probes ? static_cast<double>(tt_hits) / tt_probes : 0.0;
+    }
+    double pawnHitRate() const
+    {
+        return pawn_probes ? static_cast<double>(pawn_hits) / pawn_probes : 0.0;
+    }
+    double firstMoveCutoffRate() const
+    {
+        return beta_cutoffs ? static_cast<double>(first_move_cutoffs) / beta_cutoffs : 0.0;
+    }
+};
+
+using SearchCallback = std::function<void(const SearchIteration &)>;
+
+// Iterative-deepening negamax alpha-beta from pos, side-to-move relative.
+// state holds the game so far, so repetitions of earlier game positions are
+// seen; the search pushes its own moves onto it and leaves both pos and state
+// as they were. on_iteration runs after every finished depth. Entries in tt
+// and in pawns from earlier searches are reused.
+//
+// With limits.threads > 1 this is Lazy SMP: helper threads search the same
+// root on their own copies of pos and state and share only tt, the stop flag
+// and the node count. Odd helpers run one ply ahead of the main thread so the
+// threads spread over different depths. The result, PV and iterations are
+// the main thread's; nodes and TT counters cover all threads. Search thread i
+// evaluates pawns with pawns.thread(i).
+SearchResult search(Position &pos, StateStack &state, TranspositionTable &tt, PawnTables &pawns,
+                    const SearchLimits &limits, const SearchCallback &on_iteration = nullptr);
+// Same, with the calling thread's defaultPawnTables().
+SearchResult search(Position &pos, StateStack &state, TranspositionTable &tt, const SearchLimits &limits,
+                    const SearchCallback &on_iteration = nullptr);
+// Same, with defaultTT().
+SearchResult search(Position &pos, StateStack &state, const SearchLimits &limits,
+                    const SearchCallback &on_iteration = nullptr);
+// Same, on the calling thread's default stack and defaultTT().
+SearchResult search(Position &pos, const SearchLimits &limits, const SearchCallback &on_iteration = nullptr);
@@ -0,0 +1,16 @@
+#pragma once
+#include "chess/types.hpp"
+#include "chess/move.hpp"
+#include "chess/position.hpp"
+
+// Static exchange evaluation: the material the side to move ends up with
+// after move and the best sequence of recaptures on its target square, each
+// side always recapturing with its least valuable attacker and free to stop.
+// Uses PIECE_VALUE; pins and checks are ignored, as usual for SEE.
+int see(const Position &pos, const Move &move);
+
+// see(pos, move) >= threshold.
+inline bool seeAtLeast(const Position &pos, const Move &move, int threshold)
+{
+    return see(pos, move) >= threshold;
+}
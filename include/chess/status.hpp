@@ -17,4 +17,11 @@ class Move;
 #include "chess/attacks.hpp"
 #include "chess/bitboard.hpp"
 
+struct StateStack;
+
+// K v K, a lone minor, two knights, or one minor each: no mate can be forced.
+bool insufficientMaterial(const Position &pos);
+
 GameStatus assessStatus(Position &pos);
+// Same, with repetition checked against the given game/search stack.
+GameStatus assessStatus(Position &pos, const StateStack &state);
@@ -0,0 +1,70 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include "chess/move.hpp"
+
+// The side to move's clock, as UCI "go" gives it.
+struct TimeControl
+{
+    std::int64_t time_ms = 0;      // left on our clock
+    std::int64_t inc_ms = 0;       // added after each move
+    int moves_to_go = 0;           // until the next time control; 0 = rest of the game
+    std::int64_t overhead_ms = 30; // kept back for the GUI and the operating system
+};
+
+// Turns a clock into deadlines for one move and decides, after every
+// iteration, whether to start another.
+//
+// The optimum is what a move should normally take. No new iteration
+// starts once the elapsed time passes the optimum times a scale that
+// grows while the best move keeps changing or the score drops (a fail
+// low), and shrinks once the best move has held for a few iterations;
+// nor does one start that, at the node rate seen so far, could not finish
+// before the maximum. The maximum is hard: the search checks it every 1024
+// nodes per thread, not per node, and stops mid-iteration.
+//
+// Time normally comes from a steady clock started by start(). After
+// simulate(nps) it is nodes / nps instead, so tests can replay a search at
+// a fixed node rate and get the same decisions every run.
+class TimeManager
+{
+public:
+    TimeManager() = default;
+    explicit TimeManager(const TimeControl &tc);
+
+    // Sets the deadlines for tc and restarts the clock.
+    void start(const TimeControl &tc);
+    void simulate(double nodes_per_second);
+
+    std::int64_t optimumMs() const { return optimum_ms; }
+    std::int64_t maximumMs() const { return maximum_ms; }
+    double scale() const { return scale_; }
+
+    // Time since start(); nodes are the search's total so far.
+    double elapsedMs(std::uint64_t nodes) const;
+    // True once the hard deadline has passed.
+    bool hardLimitReached(std::uint64_t nodes) const { return elapsedMs(nodes) >= static_cast<double>(maximum_ms); }
+
+    // The root search failed low in the current iteration.
+    void failLow() { fail_low = true; }
+    // A finished iteration: its best move and score, and the search's
+    // total node count. Returns true when no further iteration should start.
+    bool iterationDone(PackedMove best, int score, std::uint64_t nodes);
+
+private:
+    std::int64_t optimum_ms = 0;
+    std::int64_t maximum_ms = 0;
+    std::chrono::steady_clock::time_point started = std::chrono::steady_clock::now();
+    double simulated_nps = 0; // > 0: simulated clock
+
+    // Per-search state, reset by start().
+    double scale_ = 1.0;
+    PackedMove last_best;
+    int last_score = 0;
+    bool have_last = false;
+    double best_changes = 0; // decaying count of best-move changes
+    int stable_iterations = 0;
+    bool fail_low = false;
+    std::uint64_t last_nodes = 0;      // total after the previous iteration
+    std::uint64_t last_iter_nodes = 0; // the previous iteration's own nodes
+};
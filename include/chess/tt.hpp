@@ -0,0 +1,96 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "chess/move.hpp"
+
+enum Bound : std::uint8_t
+{
+    BOUND_NONE = 0,
+    BOUND_UPPER = 1, // fail low: score <= the real value's upper bound
+    BOUND_LOWER = 2, // fail high: score >= the real value
+    BOUND_EXACT = 3
+};
+
+// What a probe hands back, unpacked.
+struct TTData
+{
+    PackedMove move;
+    int score = 0;
+    int depth = 0;
+    Bound bound = BOUND_NONE;
+};
+
+// Transposition table keyed on Position::zobrist. Buckets are one 64-byte
+// cache line holding four 16-byte entries: key ^ data and a packed word
+//   bits  0-15 move, 16-31 score, 32-39 depth, 40-41 bound, 42-47 age.
+// The age is the search generation that last wrote the entry, so stale
+// entries from earlier searches are replaced first.
+//
+// Search threads share one table without locks. Both words are relaxed
+// atomics and the key is stored XORed with the data, so an entry torn by
+// two concurrent writers fails the key check and reads as a miss instead of
+// handing back another position's move and score.
+class TranspositionTable
+{
+public:
+    static constexpr int BUCKET_ENTRIES = 4;
+
+    explicit TranspositionTable(std::size_t mb = 16);
+
+    // Reallocates to the largest power-of-two bucket count that fits in mb
+    // megabytes and clears the table. resize, clear and newSearch must not
+    // run while a search is using the table; probe, store and prefetch may
+    // be called from any number of threads at once.
+    void resize(std::size_t mb);
+    void clear();
+    // Starts a new generation; call once per search.
+    void newSearch();
+
+    bool probe(std::uint64_t key, TTData &out) const;
+    // Keeps the old move when move is none and the key matches. A shallower
+    // non-exact result does not overwrite a deeper entry for the same key
+    // from this search.
+    void store(std::uint64_t key, PackedMove move, int score, int depth, Bound bound);
+
+    // Pulls key's bucket towards the cache. Call right after makeMove, before
+    // the move generator runs, so the line is there by the time we probe.
+    void prefetch(std::uint64_t key) const
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(&buckets_[key & mask_]);
+#endif
+    }
+
+    // Entries written by the current search, per mille, sampled over the
+    // first 1000 buckets (or all of them in a smaller table).
+    int hashfull() const;
+    std::size_t sizeBytes() const { return (mask_ + 1) * sizeof(Bucket); }
+
+private:
+    struct Entry
+    {
+        std::atomic<std::uint64_t> key_xor_data{0};
+        std::atomic<std::uint64_t> data{0};
+    };
+    struct alignas(64) Bucket
+    {
+        Entry entries[BUCKET_ENTRIES];
+    };
+    static_assert(sizeof(Bucket) == 64, "a bucket must fill exactly one cache line");
+
+    // C++17 aligned new honours alignas(64), so every bucket starts a line.
+    std::unique_ptr<Bucket[]> buckets_;
+    std::uint64_t mask_ = 0;
+    std::uint8_t age_ = 0;
+};
+
+// Shared by every search that is not handed a table of its own. Allocated
+// at the default 16 MB on first use; resize it to change the hash size.
+TranspositionTable &defaultTT();
+
+// Mate scores are stored relative to the node rather than the root, so an
+// entry reached through a different path length still reads correctly.
+int scoreToTT(int score, int ply);
+int scoreFromTT(int score, int ply);
@@ -0,0 +1,69 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "chess/position.hpp"
+#include "chess/make_undo.hpp"
+#include "chess/search.hpp"
+#include "chess/tt.hpp"
+#include "chess/nnue.hpp"
+#include "chess/timeman.hpp"
+
+// Universal Chess Interface front end: uci, isready, ucinewgame, position,
+// go, stop, setoption (Hash, Threads, Move Overhead, EvalFile) and quit, plus
+// "go perft N". Answers go to out. "go" runs the search on a worker thread
+// of its own, so "stop" and "isready" are handled while it thinks; the
+// worker prints info lines and the bestmove when it is done.
+class UciEngine
+{
+public:
+    explicit UciEngine(std::ostream &out);
+    ~UciEngine();
+    UciEngine(const UciEngine &) = delete;
+    UciEngine &operator=(const UciEngine &) = delete;
+
+    // Handles one command line. Returns false once the engine should exit.
+    bool command(const std::string &line);
+    // Reads commands from in until "quit". At end of input a search still
+    // running is allowed to finish, unless it is infinite.
+    void loop(std::istream &in);
+    // Blocks until the current search, if any, has printed its bestmove.
+    void wait();
+
+private:
+    void send(const std::string &line);
+    void setPosition(std::istream &args);
+    void go(std::istream &args);
+    void perft(int depth);
+    void setOption(std::istream &args);
+    // Stops the current search, if any, and waits for its bestmove.
+    void stopSearch();
+
+    std::ostream &out;
+    std::mutex out_mutex;
+
+    Position pos;
+    StateStack state;
+    TranspositionTable tt;
+    PawnTables pawns;
+    int threads = 1;
+    std::int64_t move_overhead_ms = 30; // kept back from the clock
+    TimeManager timer;
+    Nnue::Network network;
+    std::string eval_file;
+
+    // The worker's own copies, so the game can be inspected while it runs.
+    Position search_pos;
+    StateStack search_state;
+    std::thread worker;
+    std::atomic<bool> stop{false};
+    // An infinite search holds its bestmove until "stop".
+    bool infinite = false;
+    std::mutex stop_mutex;
+    std::condition_variable stop_cv;
+};
@@ -14,6 +14,8 @@ extern std::uint64_t SIDE;
 void init();
 
 std::uint64_t compute(const Position& pos);
+// Key of the pawns alone: the WP/BP entries of PIECE_SQ and nothing else.
+std::uint64_t computePawnKey(const Position& pos);
 
 inline int piece_index(Piece p) {
     switch (p) {
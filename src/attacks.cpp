@@ -1,16 +1,20 @@
 #include "chess/attacks.hpp"
+#include "chess/magic.hpp"
+#include "chess/cpu.hpp"
 #include "chess/move.hpp"
 #include <array>
 
 std::array<Bitboard, 64> generateKingMoveTable();
 std::array<Bitboard, 64> generateKnightMoveTable();
 std::array<std::array<Bitboard, 64>, 2> generatePawnCaptureTable();
+std::array<std::array<Bitboard, 64>, 64> generateBetweenTable();
 
 const std::array<Bitboard, 64> KING_TABLE = generateKingMoveTable();
 const std::array<Bitboard, 64> KNIGHT_TABLE = generateKnightMoveTable();
 const std::array<std::array<Bitboard, 64>, 2> PAWN_CAPTURE_TABLE = generatePawnCaptureTable();
+const std::array<std::array<Bitboard, 64>, 64> BETWEEN_TABLE = generateBetweenTable();
 
-Bitboard computeRookMove(int sq, Bitboard curr)
+Bitboard computeRookMoveRay(int sq, Bitboard curr)
 {
 
     Bitboard temp = convert_to_bit(sq);
@@ -80,7 +84,7 @@ Bitboard computeRookMove(int sq, Bitboard curr)
 
     return result;
 }
-Bitboard computeBishopMove(int sq, Bitboard curr)
+Bitboard computeBishopMoveRay(int sq, Bitboard curr)
 {
 
     Bitboard temp = convert_to_bit(sq);
@@ -149,6 +153,66 @@ Bitboard computeBishopMove(int sq, Bitboard curr)
     }
     return result;
 }
+static SliderBackend bestSliderBackend()
+{
+#ifdef CHESS_USE_PEXT
+    if (cpuFeatures().fast_pext)
+        return SliderBackend::Pext;
+#endif
+    return SliderBackend::Magic;
+}
+
+static SliderBackend g_slider_backend = bestSliderBackend();
+
+bool setSliderBackend(SliderBackend backend)
+{
+    if (backend == SliderBackend::Pext)
+    {
+#ifdef CHESS_USE_PEXT
+        initMagics();
+        if (!pextAvailable())
+            return false;
+#else
+        return false;
+#endif
+    }
+    g_slider_backend = backend;
+    return true;
+}
+
+SliderBackend sliderBackend()
+{
+    return g_slider_backend;
+}
+
+Bitboard computeRookMove(int sq, Bitboard curr)
+{
+    switch (g_slider_backend)
+    {
+#ifdef CHESS_USE_PEXT
+    case SliderBackend::Pext:
+        return pextRookAttacks(sq, curr);
+#endif
+    case SliderBackend::Magic:
+        return magicRookAttacks(sq, curr);
+    default:
+        return computeRookMoveRay(sq, curr);
+    }
+}
+Bitboard computeBishopMove(int sq, Bitboard curr)
+{
+    switch (g_slider_backend)
+    {
+#ifdef CHESS_USE_PEXT
+    case SliderBackend::Pext:
+        return pextBishopAttacks(sq, curr);
+#endif
+    case SliderBackend::Magic:
+        return magicBishopAttacks(sq, curr);
+    default:
+        return computeBishopMoveRay(sq, curr);
+    }
+}
 Bitboard computeQueenMove(int sq, Bitboard curr)
 {
     return computeBishopMove(sq, curr) | computeRookMove(sq, curr);
@@ -186,6 +250,16 @@ bool isPieceAttacked(int sq, Color opp, const Position &pos)
     return false;
 }
 
+Bitboard attackersTo(int sq, Bitboard occ, const Position &pos)
+{
+    return (PAWN_CAPTURE_TABLE[BLACK][sq] & pos.P) |
+           (PAWN_CAPTURE_TABLE[WHITE][sq] & pos.p) |
+           (KNIGHT_TABLE[sq] & (pos.N | pos.n)) |
+           (KING_TABLE[sq] & (pos.K | pos.k)) |
+           (computeBishopMove(sq, occ) & (pos.B | pos.b | pos.Q | pos.q)) |
+           (computeRookMove(sq, occ) & (pos.R | pos.r | pos.Q | pos.q));
+}
+
 int kingSquare(Color side, const Position &pos)
 {
     return (side == WHITE) ? peek_lsb(pos.K) : peek_lsb(pos.k);
@@ -243,3 +317,24 @@ std::array<std::array<Bitboard, 64>, 2> generatePawnCaptureTable()
     }
     return table;
 }
+std::array<std::array<Bitboard, 64>, 64> generateBetweenTable()
+{
+    std::array<std::array<Bitboard, 64>, 64> table{};
+    for (int a = 0; a < 64; a++)
+    {
+        for (int b = 0; b < 64; b++)
+        {
+            if (is_Piece(computeRookMoveRay(a, 0), b))
+            {
+                table[a][b] = computeRookMoveRay(a, convert_to_bit(b)) &
+                              computeRookMoveRay(b, convert_to_bit(a));
+            }
+            else if (is_Piece(computeBishopMoveRay(a, 0), b))
+            {
+                table[a][b] = computeBishopMoveRay(a, convert_to_bit(b)) &
+                              computeBishopMoveRay(b, convert_to_bit(a));
+            }
+        }
+    }
+    return table;
+}
@@ -0,0 +1,322 @@
+// src/bench_main.cpp  (chess_bench: search throughput benchmark)
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "chess/position.hpp"
+#include "chess/move.hpp"
+#include "chess/search.hpp"
+#include "chess/fen.hpp"
+#include "chess/cli.hpp"
+#include "chess/nnue.hpp"
+
+struct Options
+{
+    std::vector<std::string> fens;
+    SearchLimits limits;
+    std::size_t hash_mb = 16;
+    std::string nnue_path;
+    bool smp = false;
+    bool ordering = false;
+    bool features = false;
+    bool threads_set = false;
+};
+
+// Opening, middlegame and endgame positions with a mix of quiet and tactical play.
+static const std::vector<std::string> &benchPositions()
+{
+    static const std::vector<std::string> fens = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+        "r1bq1rk1/pp2bppp/2n1pn2/3p4/2PP4/2N1PN2/PP1B1PPP/R2QKB1R w KQ - 0 8",
+        "2r2rk1/1b2qppp/p3pn2/1p6/3P4/P1NBQ3/1P3PPP/R4RK1 w - - 0 18",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "8/8/4k3/3p4/3P4/4K3/8/8 w - - 0 1",
+    };
+    return fens;
+}
+
+static std::string pvString(const std::vector<Move> &pv)
+{
+    std::string out;
+    for (const Move &m : pv)
+    {
+        if (!out.empty())
+            out += ' ';
+        out += move_to_uci(m);
+    }
+    return out;
+}
+
+static std::string scoreString(int score)
+{
+    if (!isMateScore(score))
+        return "cp " + std::to_string(score);
+    int plies = MATE_SCORE - std::abs(score);
+    int moves = (plies + 1) / 2;
+    return "mate " + std::to_string(score > 0 ? moves : -moves);
+}
+
+// Time to depth over the whole position set for each thread count, from a
+// cold table every time. Speedup and efficiency are against one thread.
+static void smpScaling(const Options &opt, TranspositionTable &tt)
+{
+    int max_threads = opt.threads_set ? opt.limits.threads : 32;
+    std::cout << "Time to depth " << opt.limits.depth << " over " << opt.fens.size() << " positions\n";
+    double base = 0;
+    for (int threads : {1, 2, 4, 8, 16, 32})
+    {
+        if (threads > max_threads)
+            break;
+        SearchLimits limits = opt.limits;
+        limits.threads = threads;
+        std::uint64_t nodes = 0;
+        double seconds = 0;
+        for (const std::string &fen : opt.fens)
+        {
+            Position pos;
+            loadFEN(pos, fen);
+            tt.clear();
+            SearchResult r = search(pos, defaultStateStack(), tt, limits);
+            nodes += r.nodes;
+            seconds += r.seconds;
+        }
+        if (threads == 1)
+            base = seconds;
+        double speedup = seconds > 0 ? base / seconds : 0;
+        std::cout << " threads " << std::setw(2) << threads
+                  << "  time " << std::setw(7) << static_cast<long long>(seconds * 1000.0) << " ms"
+                  << "  nodes " << std::setw(11) << nodes
+                  << "  nps " << std::setw(10) << static_cast<std::uint64_t>(seconds > 0 ? nodes / seconds : 0)
+                  << "  speedup " << std::fixed << std::setprecision(2) << speedup
+                  << "  efficiency " << std::setprecision(1) << 100.0 * speedup / threads << "%\n"
+                  << std::defaultfloat;
+    }
+}
+
+// Nodes to reach each depth with moves in generation order and with the
+// move picker, from a cold table every time, plus how often a cutoff came
+// from the first move tried.
+static void orderingComparison(const Options &opt, TranspositionTable &tt)
+{
+    std::uint64_t totals[2] = {0, 0};
+    for (const std::string &fen : opt.fens)
+    {
+        Position pos;
+        loadFEN(pos, fen);
+        SearchResult runs[2];
+        for (int ordered = 0; ordered < 2; ordered++)
+        {
+            SearchLimits limits = opt.limits;
+            limits.move_ordering = ordered == 1;
+            tt.clear();
+            runs[ordered] = search(pos, defaultStateStack(), tt, limits);
+            totals[ordered] += runs[ordered].nodes;
+        }
+        std::cout << fen << "\n";
+        std::size_t depths = std::min(runs[0].iterations.size(), runs[1].iterations.size());
+        for (std::size_t i = 0; i < depths; i++)
+        {
+            std::uint64_t plain = runs[0].iterations[i].nodes, picked = runs[1].iterations[i].nodes;
+            std::cout << " depth " << std::setw(2) << runs[1].iterations[i].depth
+                      << "  unordered " << std::setw(11) << plain
+                      << "  ordered " << std::setw(10) << picked
+                      << "  ratio " << std::fixed << std::setprecision(2)
+                      << (picked ? static_cast<double>(plain) / picked : 0.0) << std::defaultfloat << "\n";
+        }
+        std::cout << " first-move cutoffs  unordered " << std::fixed << std::setprecision(1)
+                  << 100.0 * runs[0].firstMoveCutoffRate() << "%  ordered "
+                  << 100.0 * runs[1].firstMoveCutoffRate() << "%\n\n"
+                  << std::defaultfloat;
+    }
+    std::cout << "Total: unordered " << totals[0] << "  ordered " << totals[1] << "  ratio " << std::fixed
+              << std::setprecision(2) << (totals[1] ? static_cast<double>(totals[0]) / totals[1] : 0.0) << "\n";
+}
+
+// Nodes and time to depth over the position set with every selectivity
+// feature on, with each one switched off in turn, and with all of them off.
+static void featureComparison(const Options &opt, TranspositionTable &tt)
+{
+    struct Variant
+    {
+        const char *name;
+        bool SearchLimits::*flag; // null: all on, or all off when all_off is set
+        bool all_off;
+    };
+    static const Variant variants[] = {
+        {"all on", nullptr, false},
+        {"no null move", &SearchLimits::null_move, false},
+        {"no LMR", &SearchLimits::lmr, false},
+        {"no futility", &SearchLimits::futility, false},
+        {"no reverse futility", &SearchLimits::reverse_futility, false},
+        {"no aspiration", &SearchLimits::aspiration, false},
+        {"all off", nullptr, true},
+    };
+
+    std::cout << "Time to depth " << opt.limits.depth << " over " << opt.fens.size() << " positions\n";
+    std::uint64_t base_nodes = 0;
+    for (const Variant &v : variants)
+    {
+        SearchLimits limits = opt.limits;
+        if (v.flag)
+            limits.*v.flag = false;
+        if (v.all_off)
+            limits.null_move = limits.lmr = limits.futility = limits.reverse_futility = limits.aspiration = false;
+        std::uint64_t nodes = 0;
+        double seconds = 0;
+        for (const std::string &fen : opt.fens)
+        {
+            Position pos;
+            loadFEN(pos, fen);
+            tt.clear();
+            SearchResult r = search(pos, defaultStateStack(), tt, limits);
+            nodes += r.nodes;
+            seconds += r.seconds;
+        }
+        if (!v.flag && !v.all_off)
+            base_nodes = nodes;
+        std::cout << " " << std::left << std::setw(20) << v.name << std::right
+                  << "  nodes " << std::setw(11) << nodes
+                  << "  time " << std::setw(7) << static_cast<long long>(seconds * 1000.0) << " ms"
+                  << "  nodes vs all on " << std::fixed << std::setprecision(2)
+                  << (base_nodes ? static_cast<double>(nodes) / base_nodes : 0.0) << "x\n"
+                  << std::defaultfloat;
+    }
+}
+
+static void usage()
+{
+    std::cout << "usage: chess_bench [options]\n"
+              << "  --fen \"<FEN>\"   search this position instead of the bench set (repeatable)\n"
+              << "  --depth N       iterative deepening depth (default 5)\n"
+              << "  --nodes N       stop each search after N nodes\n"
+              << "  --movetime MS   stop each search after MS milliseconds\n"
+              << "  --hash MB       transposition table size (default 16)\n"
+              << "  --threads N     Lazy SMP search threads (default 1)\n"
+              << "  --nnue FILE     evaluate with this network (e.g. assets/test.nnue)\n"
+              << "  --smp           time-to-depth on 1, 2, 4, 8, 16, 32 threads (up to --threads)\n"
+              << "  --ordering      nodes to depth with and without move ordering\n"
+              << "  --features      nodes and time to depth with each pruning feature switched off\n";
+}
+
+int main(int argc, char **argv)
+{
+    Options opt;
+    opt.limits.depth = 5;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--fen" && i + 1 < argc)
+            opt.fens.push_back(argv[++i]);
+        else if (arg == "--depth" && i + 1 < argc)
+            opt.limits.depth = std::atoi(argv[++i]);
+        else if (arg == "--nodes" && i + 1 < argc)
+            opt.limits.nodes = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--movetime" && i + 1 < argc)
+            opt.limits.movetime_ms = std::atoll(argv[++i]);
+        else if (arg == "--hash" && i + 1 < argc)
+            opt.hash_mb = static_cast<std::size_t>(std::atoll(argv[++i]));
+        else if (arg == "--threads" && i + 1 < argc)
+        {
+            opt.limits.threads = std::atoi(argv[++i]);
+            opt.threads_set = true;
+        }
+        else if (arg == "--nnue" && i + 1 < argc)
+            opt.nnue_path = argv[++i];
+        else if (arg == "--smp")
+            opt.smp = true;
+        else if (arg == "--ordering")
+            opt.ordering = true;
+        else if (arg == "--features")
+            opt.features = true;
+        else
+        {
+            usage();
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+    }
+    if (opt.limits.depth < 1)
+    {
+        std::cout << "depth must be at least 1\n";
+        return 1;
+    }
+    if (opt.limits.threads < 1)
+    {
+        std::cout << "thread count must be at least 1\n";
+        return 1;
+    }
+    if (opt.fens.empty())
+        opt.fens = benchPositions();
+    Nnue::Network network;
+    if (!opt.nnue_path.empty())
+    {
+        std::string error;
+        if (!network.load(opt.nnue_path, &error))
+        {
+            std::cout << error << "\n";
+            return 1;
+        }
+        opt.limits.network = &network;
+    }
+    TranspositionTable tt(opt.hash_mb);
+    if (opt.smp)
+    {
+        smpScaling(opt, tt);
+        return 0;
+    }
+    if (opt.ordering)
+    {
+        orderingComparison(opt, tt);
+        return 0;
+    }
+    if (opt.features)
+    {
+        featureComparison(opt, tt);
+        return 0;
+    }
+
+    std::uint64_t total_nodes = 0, total_qnodes = 0;
+    double total_seconds = 0;
+    for (const std::string &fen : opt.fens)
+    {
+        Position pos;
+        if (!loadFEN(pos, fen))
+        {
+            std::cout << "bad FEN: " << fen << "\n";
+            return 1;
+        }
+        std::cout << fen << "\n";
+        // Every position starts from an empty table so runs are repeatable.
+        tt.clear();
+        SearchResult r = search(pos, defaultStateStack(), tt, opt.limits, [](const SearchIteration &it) {
+            std::uint64_t nps = it.seconds > 0 ? static_cast<std::uint64_t>(it.nodes / it.seconds) : 0;
+            std::cout << " depth " << std::setw(2) << it.depth
+                      << "  " << std::left << std::setw(9) << scoreString(it.score) << std::right
+                      << "  nodes " << std::setw(10) << it.nodes
+                      << "  time " << std::setw(6) << static_cast<long long>(it.depth_seconds * 1000.0) << " ms"
+                      << "  nps " << std::setw(9) << nps
+                      << "  pv " << pvString(it.pv) << "\n";
+        });
+        std::cout << " best " << (r.has_move ? move_to_uci(r.best_move) : std::string("(none)"))
+                  << (r.stopped ? "  (stopped by limit)" : "")
+                  << "  qnodes " << std::fixed << std::setprecision(1) << 100.0 * r.qnodeShare() << "%"
+                  << "  tt hits " << std::fixed << std::setprecision(1) << 100.0 * r.ttHitRate() << "%"
+                  << "  pawn hits " << 100.0 * r.pawnHitRate() << "%"
+                  << "  first-move cutoffs " << 100.0 * r.firstMoveCutoffRate() << "%"
+                  << std::defaultfloat << "  hashfull " << r.hashfull << "\n\n";
+        total_nodes += r.nodes;
+        total_qnodes += r.qnodes;
+        total_seconds += r.seconds;
+    }
+    std::cout << "Total: nodes " << total_nodes
+              << "  time " << static_cast<long long>(total_seconds * 1000.0) << " ms"
+              << "  nps " << static_cast<std::uint64_t>(total_seconds > 0 ? total_nodes / total_seconds : 0)
+              << "  qnodes " << std::fixed << std::setprecision(1)
+              << (total_nodes ? 100.0 * total_qnodes / total_nodes : 0.0) << "%\n";
+    return 0;
+}
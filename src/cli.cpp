@@ -1,4 +1,8 @@
 #include "chess/cli.hpp"
+#include "chess/search.hpp"
+#include "chess/fen.hpp"
+#include <cstdlib>
+#include <limits>
 
 static inline void wait_for_enter()
 {
@@ -7,7 +11,7 @@ static inline void wait_for_enter()
     std::cin.get();
 }
 
-inline std::string sq_to_str(int idx)
+std::string sq_to_str(int idx)
 {
     if (idx < 0 || idx > 63)
         return "--";
@@ -16,7 +20,7 @@ inline std::string sq_to_str(int idx)
     return std::string{f, r};
 }
 
-inline char promo_char(uint8_t promo)
+char promo_char(uint8_t promo)
 {
     switch (promo)
     {
@@ -33,7 +37,7 @@ inline char promo_char(uint8_t promo)
     }
 }
 
-inline std::string move_to_uci(const Move &m)
+std::string move_to_uci(const Move &m)
 {
     std::string s;
     if (m.from >= 0 && m.to >= 0)
@@ -46,9 +50,9 @@ inline std::string move_to_uci(const Move &m)
     return s;
 }
 
-inline const char *side_name(Color c) { return c == WHITE ? "White" : "Black"; }
+const char *side_name(Color c) { return c == WHITE ? "White" : "Black"; }
 
-inline char piece_to_char(Piece p)
+char piece_to_char(Piece p)
 {
     switch (p)
     {
@@ -81,7 +85,7 @@ inline char piece_to_char(Piece p)
     }
 }
 
-inline std::string board_row_string(const Position &pos, int rank)
+std::string board_row_string(const Position &pos, int rank)
 {
     std::ostringstream oss;
     oss << (rank + 1) << "   ";
@@ -93,7 +97,7 @@ inline std::string board_row_string(const Position &pos, int rank)
     return oss.str();
 }
 
-inline void clear_screen()
+void clear_screen()
 {
 #ifdef _WIN32
     std::system("cls");
@@ -276,15 +280,99 @@ Move convert_command(Position &pos, std::string command)
     return m;
 }
 
+// Thinking time per move for Player vs Computer, and for Analysis.
+static const std::int64_t ENGINE_MOVETIME_MS = 1000;
+static const std::int64_t ANALYSIS_MOVETIME_MS = 5000;
+
+// Iterative deepening on a FEN (or the start position), one line per depth.
+static void analyse()
+{
+    std::cout << "FEN (empty for the start position): ";
+    std::string fen;
+    std::cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
+    std::getline(std::cin, fen);
+
+    Position pos;
+    if (fen.empty())
+        pos.start_position();
+    else if (!loadFEN(pos, fen))
+    {
+        std::cout << "Bad FEN.\n";
+        return;
+    }
+
+    SearchLimits limits;
+    limits.movetime_ms = ANALYSIS_MOVETIME_MS;
+    SearchResult r = search(pos, limits, [](const SearchIteration &it) {
+        std::cout << "depth " << std::setw(2) << it.depth << "  score " << std::setw(6);
+        if (isMateScore(it.score))
+            std::cout << ((it.score > 0 ? "#" : "#-") + std::to_string((MATE_SCORE - std::abs(it.score) + 1) / 2));
+        else
+            std::cout << it.score;
+        std::cout << "  nodes " << std::setw(9) << it.nodes
+                  << "  time " << std::setw(5) << static_cast<long long>(it.seconds * 1000.0) << " ms  pv";
+        for (const Move &m : it.pv)
+            std::cout << ' ' << move_to_uci(m);
+        std::cout << "\n";
+    });
+    if (r.has_move)
+        std::cout << "Best move: " << move_to_uci(r.best_move) << " (" << r.nps() << " nodes/s)\n";
+    else
+        std::cout << "No legal moves: the game is over.\n";
+}
+
+static void print_game_over(const Position &game, const GameStatus &status,
+                            const std::vector<std::string> &moveHistoryStr, const std::string &lastMoveStr)
+{
+    print_board_with_legal(game, {}, moveHistoryStr, lastMoveStr);
+    if (status.outcome == Outcome::Whitewins)
+    {
+        std::cout << "Checkmate! White wins.\n";
+    }
+    else if (status.outcome == Outcome::Blackwins)
+    {
+        std::cout << "Checkmate! Black wins.\n";
+    }
+    else
+    {
+        std::cout << "Draw: ";
+        switch (status.draw_reason)
+        {
+        case DrawReason::Stalemate:
+            std::cout << "stalemate";
+            break;
+        case DrawReason::InsufficientMaterial:
+            std::cout << "insufficient material";
+            break;
+        case DrawReason::FiftyMove:
+            std::cout << "50-move rule";
+            break;
+        case DrawReason::Threefold:
+            std::cout << "threefold repetition";
+            break;
+        case DrawReason::Agreement:
+            std::cout << "by agreement";
+            break;
+        default:
+            std::cout << "unknown reason";
+            break;
+        }
+        std::cout << ".\n";
+    }
+    std::cout << "Press any key to return to menu...\n";
+    std::string a;
+    std::cin >> a;
+}
+
 void gameloop()
 {
     std::cout << "Welcome to Chess 1.0!\n";
     while (true)
     {
         std::cout << "\nMenu:\n"
-                  << "  A) Player vs Computer (coming soon)\n"
+                  << "  A) Player vs Computer\n"
                   << "  B) 2 Player (local)\n"
-                  << "  C) Analysis (coming soon)\n"
+                  << "  C) Analysis\n"
                   << "  D) Quit\n"
                   << "Select: ";
         char option;
@@ -296,13 +384,23 @@ void gameloop()
             std::cout << "Quitting\n";
             break;
         }
-        if (option == 'A' || option == 'C')
+        if (option == 'C')
         {
-            std::cout << "Not implemented yet. Pick B for 2-Player.\n";
+            analyse();
             continue;
         }
-        if (option == 'B')
+        if (option == 'A' || option == 'B')
         {
+            bool vs_computer = option == 'A';
+            Color computer = BLACK;
+            if (vs_computer)
+            {
+                std::cout << "Play as (w/b): ";
+                char side;
+                std::cin >> side;
+                computer = (std::tolower(side) == 'b') ? WHITE : BLACK;
+            }
+
             Position game;
             game.start_position();
             GameStatus status = assessStatus(game);
@@ -313,6 +411,25 @@ void gameloop()
 
             while (status.phase == Phase::Playing)
             {
+                if (vs_computer && game.side_to_move == computer)
+                {
+                    SearchLimits limits;
+                    limits.movetime_ms = ENGINE_MOVETIME_MS;
+                    SearchResult r = search(game, limits);
+                    makeMove(game, r.best_move);
+                    std::string uci = move_to_uci(r.best_move);
+                    moveHistory.push_back(r.best_move);
+                    moveHistoryStr.push_back(uci);
+                    lastMoveStr = uci;
+                    std::cout << "Computer plays " << uci << " (depth " << r.depth << ", "
+                              << r.nodes << " nodes)\n";
+
+                    status = assessStatus(game);
+                    if (status.phase == Phase::GameOver)
+                        print_game_over(game, status, moveHistoryStr, lastMoveStr);
+                    continue;
+                }
+
                 std::vector<Move> legal;
                 generateLegalAllMoves(game, legal);
 
@@ -357,9 +474,14 @@ void gameloop()
                         std::cout << "Nothing to undo.\n";
                         continue;
                     }
-                    UndoMove(game);
-                    moveHistory.pop_back();
-                    moveHistoryStr.pop_back();
+                    // Against the computer, take back its reply and our move.
+                    int plies = (vs_computer && moveHistory.size() >= 2) ? 2 : 1;
+                    for (int i = 0; i < plies; i++)
+                    {
+                        UndoMove(game);
+                        moveHistory.pop_back();
+                        moveHistoryStr.pop_back();
+                    }
                     lastMoveStr = moveHistoryStr.empty() ? "" : moveHistoryStr.back();
                     status = assessStatus(game);
                     continue;
@@ -390,44 +512,7 @@ void gameloop()
                 status = assessStatus(game);
                 if (status.phase == Phase::GameOver)
                 {
-                    print_board_with_legal(game, {}, moveHistoryStr, lastMoveStr);
-                    if (status.outcome == Outcome::Whitewins)
-                    {
-                        std::cout << "Checkmate! White wins.\n";
-                    }
-                    else if (status.outcome == Outcome::Blackwins)
-                    {
-                        std::cout << "Checkmate! Black wins.\n";
-                    }
-                    else
-                    {
-                        std::cout << "Draw: ";
-                        switch (status.draw_reason)
-                        {
-                        case DrawReason::Stalemate:
-                            std::cout << "stalemate";
-                            break;
-                        case DrawReason::InsufficientMaterial:
-                            std::cout << "insufficient material";
-                            break;
-                        case DrawReason::FiftyMove:
-                            std::cout << "50-move rule";
-                            break;
-                        case DrawReason::Threefold:
-                            std::cout << "threefold repetition";
-                            break;
-                        case DrawReason::Agreement:
-                            std::cout << "by agreement";
-                            break;
-                        default:
-                            std::cout << "unknown reason";
-                            break;
-                        }
-                        std::cout << ".\n";
-                    }
-                    std::cout << "Press any key to return to menu...\n";
-                    std::string a;
-                    std::cin >> a;
+                    print_game_over(game, status, moveHistoryStr, lastMoveStr);
                     break;
                 }
             }
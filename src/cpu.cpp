@@ -0,0 +1,78 @@
+#include "chess/cpu.hpp"
+#include <cstring>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define CHESS_HAVE_CPUID 1
+static void cpuid(int leaf, int sub, unsigned regs[4])
+{
+    int r[4];
+    __cpuidex(r, leaf, sub);
+    for (int i = 0; i < 4; i++)
+        regs[i] = static_cast<unsigned>(r[i]);
+}
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#define CHESS_HAVE_CPUID 1
+static void cpuid(int leaf, int sub, unsigned regs[4])
+{
+    regs[0] = regs[1] = regs[2] = regs[3] = 0;
+    __get_cpuid_count(leaf, sub, &regs[0], &regs[1], &regs[2], &regs[3]);
+}
+#endif
+
+#ifdef CHESS_HAVE_CPUID
+// XCR0: which register state the OS saves on a context switch.
+static unsigned long long xgetbv0()
+{
+#ifdef _MSC_VER
+    return _xgetbv(0);
+#else
+    unsigned eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return (static_cast<unsigned long long>(edx) << 32) | eax;
+#endif
+}
+#endif
+
+static CpuFeatures detect()
+{
+    CpuFeatures f;
+#ifdef CHESS_HAVE_CPUID
+    unsigned regs[4];
+    cpuid(0, 0, regs);
+    unsigned max_leaf = regs[0];
+    char vendor[13];
+    std::memcpy(vendor + 0, &regs[1], 4);
+    std::memcpy(vendor + 4, &regs[3], 4);
+    std::memcpy(vendor + 8, &regs[2], 4);
+    vendor[12] = '\0';
+
+    cpuid(1, 0, regs);
+    unsigned family = (regs[0] >> 8) & 0xF;
+    if (family == 0xF)
+        family += (regs[0] >> 20) & 0xFF;
+    f.sse41 = (regs[2] >> 19) & 1;
+    bool osxsave = (regs[2] >> 27) & 1;
+    bool avx = (regs[2] >> 28) & 1;
+    // XMM and YMM state (bits 1 and 2) must both be enabled.
+    bool ymm_saved = osxsave && avx && (xgetbv0() & 6) == 6;
+
+    if (max_leaf >= 7)
+    {
+        cpuid(7, 0, regs);
+        f.bmi2 = (regs[1] >> 8) & 1;
+        f.avx2 = ymm_saved && ((regs[1] >> 5) & 1);
+    }
+
+    bool amd = std::strcmp(vendor, "AuthenticAMD") == 0;
+    f.fast_pext = f.bmi2 && !(amd && family < 0x19);
+#endif
+    return f;
+}
+
+const CpuFeatures &cpuFeatures()
+{
+    static const CpuFeatures features = detect();
+    return features;
+}
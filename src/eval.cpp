@@ -0,0 +1,83 @@
+#include "chess/eval.hpp"
+#include "chess/psqt.hpp"
+#include "chess/attacks.hpp"
+#include <algorithm>
+#include <cassert>
+
+// Extra endgame bonus for a passed pawn whose next square is empty, by rank
+// counted from its own side.
+static constexpr int FREE_PASSER_EG[8] = {0, 0, 2, 5, 10, 20, 35, 0};
+
+// Linear blend: all midgame at MAX_PHASE, all endgame at 0. Promotions can
+// push the phase past the maximum, so it is capped.
+static int taper(int mg, int eg, int phase)
+{
+    phase = std::min(phase, Psqt::MAX_PHASE);
+    return (mg * phase + eg * (Psqt::MAX_PHASE - phase)) / Psqt::MAX_PHASE;
+}
+
+// Adds the terms that come from e: the cached pawn structure, each king's
+// shelter (recomputed only when that king has moved since), and the passed
+// pawns that are free to advance.
+static void addPawnTerms(const Position &pos, PawnEntry &e, int &mg, int &eg)
+{
+    mg += e.mg;
+    eg += e.eg;
+    for (Color side : {WHITE, BLACK})
+    {
+        int king = kingSquare(side, pos);
+        if (e.shelter_king[side] != king)
+        {
+            e.shelter_king[side] = static_cast<std::int8_t>(king);
+            e.shelter[side] = static_cast<std::int16_t>(kingShelter(pos, side));
+        }
+        int sign = side == WHITE ? 1 : -1;
+        mg += sign * e.shelter[side];
+
+        Bitboard passed = e.passed[side];
+        while (passed)
+        {
+            int sq = pop_lsb(passed);
+            int stop = side == WHITE ? sq + 8 : sq - 8;
+            if (!is_Piece(pos.total_pieces, stop))
+                eg += sign * FREE_PASSER_EG[side == WHITE ? sq / 8 : 7 - sq / 8];
+        }
+    }
+}
+
+static int finish(const Position &pos, int mg, int eg, int phase)
+{
+    int score = taper(mg, eg, phase);
+    return pos.side_to_move == WHITE ? score : -score;
+}
+
+int evaluate(const Position &pos, PawnTable &pawns)
+{
+#ifdef CHESS_VERIFY_INCREMENTAL
+    int mg0, eg0, phase0;
+    Psqt::compute(pos, mg0, eg0, phase0);
+    assert(mg0 == pos.psq_mg && eg0 == pos.psq_eg && phase0 == pos.phase && "evaluate: incremental eval terms drifted");
+#endif
+    int mg = pos.psq_mg, eg = pos.psq_eg;
+    addPawnTerms(pos, pawns.probe(pos), mg, eg);
+    return finish(pos, mg, eg, pos.phase);
+}
+
+int evaluate(const Position &pos)
+{
+    PawnEntry e;
+    evaluatePawns(pos, e);
+    int mg = pos.psq_mg, eg = pos.psq_eg;
+    addPawnTerms(pos, e, mg, eg);
+    return finish(pos, mg, eg, pos.phase);
+}
+
+int evaluateFromScratch(const Position &pos)
+{
+    int mg, eg, phase;
+    Psqt::compute(pos, mg, eg, phase);
+    PawnEntry e;
+    evaluatePawns(pos, e);
+    addPawnTerms(pos, e, mg, eg);
+    return finish(pos, mg, eg, phase);
+}
@@ -154,7 +154,9 @@ bool loadFEN(Position &pos, std::string FENstr)
         pos.fullmove = 1;
 
     pos.board_state();
+    Zobrist::init();
     pos.zobrist = Zobrist::compute(pos);
+    pos.pawn_key = Zobrist::computePawnKey(pos);
     rep_init(pos);                       // <-- ADD THIS
     return true;    
 
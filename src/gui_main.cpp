@@ -281,8 +281,7 @@ int main() {
             if (auto* key = ev->getIf<sf::Event::KeyPressed>()) {
                 if (key->code == sf::Keyboard::Key::U) {
                     if (!ui.gameOver) {
-                        extern std::stack<MoveHistory> history;
-                        if (!history.empty()) {
+                        if (!defaultStateStack().moves.empty()) {
                             UndoMove(pos);
                             ui.lastMove.reset();
                             recompute_status();
@@ -0,0 +1,168 @@
+#include "chess/magic.hpp"
+#include "chess/attacks.hpp"
+#include "chess/bitboard.hpp"
+#include "chess/cpu.hpp"
+
+#ifdef CHESS_USE_PEXT
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define CHESS_TARGET_BMI2 __attribute__((target("bmi2")))
+#else
+#define CHESS_TARGET_BMI2
+#endif
+#endif
+
+Magic ROOK_MAGICS[64];
+Magic BISHOP_MAGICS[64];
+
+static Bitboard SLIDER_ATTACKS[ROOK_TABLE_SIZE + BISHOP_TABLE_SIZE];
+
+// xorshift64* keeps the search deterministic, so every run builds the same tables.
+static inline std::uint64_t magic_rand(std::uint64_t &s)
+{
+    s ^= s >> 12;
+    s ^= s << 25;
+    s ^= s >> 27;
+    return s * 2685821657736338717ULL;
+}
+
+// Edge squares never block anything beyond themselves, so they are left out of
+// the relevant-occupancy mask unless the slider sits on that edge.
+static Bitboard relevant_mask(int sq, bool rook)
+{
+    Bitboard edges = ((RANK_1 | RANK_8) & ~(RANK_1 << (8 * (sq / 8)))) |
+                     ((FILE_A | FILE_H) & ~(FILE_A << (sq % 8)));
+    Bitboard rays = rook ? computeRookMoveRay(sq, 0) : computeBishopMoveRay(sq, 0);
+    return rays & ~edges;
+}
+
+static Bitboard *init_slider(Magic *table, Bitboard *base, bool rook)
+{
+    // Per-rank seeds that are known to converge quickly for this generator.
+    static const std::uint64_t seeds[8] = {728, 10316, 55013, 32803, 12281, 15100, 16645, 255};
+
+    static Bitboard occupancy[4096];
+    static Bitboard reference[4096];
+    static int epoch[4096];
+    static int attempt = 0;
+
+    for (int sq = 0; sq < 64; sq++)
+    {
+        Magic &m = table[sq];
+        m.mask = relevant_mask(sq, rook);
+        m.shift = 64 - bits_set_count(m.mask);
+        m.attacks = base;
+
+        // Carry-Rippler walk over every subset of the mask.
+        int size = 0;
+        Bitboard b = 0;
+        do
+        {
+            occupancy[size] = b;
+            reference[size] = rook ? computeRookMoveRay(sq, b) : computeBishopMoveRay(sq, b);
+            size++;
+            b = (b - m.mask) & m.mask;
+        } while (b);
+
+        std::uint64_t seed = seeds[sq / 8];
+        for (int i = 0; i < size;)
+        {
+            do
+            {
+                m.magic = magic_rand(seed) & magic_rand(seed) & magic_rand(seed);
+            } while (bits_set_count((m.magic * m.mask) >> 56) < 6);
+
+            // Epoch stamps avoid clearing the slice between failed candidates.
+            ++attempt;
+            for (i = 0; i < size; i++)
+            {
+                unsigned idx = m.index(occupancy[i]);
+                if (epoch[idx] < attempt)
+                {
+                    epoch[idx] = attempt;
+                    m.attacks[idx] = reference[i];
+                }
+                else if (m.attacks[idx] != reference[i])
+                {
+                    break;
+                }
+            }
+        }
+        base += size;
+    }
+    return base;
+}
+
+#ifdef CHESS_USE_PEXT
+static Bitboard PEXT_ATTACKS[ROOK_TABLE_SIZE + BISHOP_TABLE_SIZE];
+static Bitboard *PEXT_ROOK[64];
+static Bitboard *PEXT_BISHOP[64];
+static bool g_pext_ready = false;
+
+// Portable PEXT, only used while filling the table so initialisation itself
+// never executes a BMI2 instruction.
+static Bitboard soft_pext(Bitboard src, Bitboard mask)
+{
+    Bitboard result = 0;
+    for (Bitboard bit = 1; mask; bit <<= 1)
+    {
+        if (src & mask & -mask)
+            result |= bit;
+        mask &= mask - 1;
+    }
+    return result;
+}
+
+// Reuses the magic slice layout: square sq gets 2^popcount(mask) entries at
+// the same offset it has in SLIDER_ATTACKS.
+static void init_pext(const Magic *table, Bitboard **slices)
+{
+    for (int sq = 0; sq < 64; sq++)
+    {
+        const Magic &m = table[sq];
+        slices[sq] = PEXT_ATTACKS + (m.attacks - SLIDER_ATTACKS);
+        Bitboard b = 0;
+        do
+        {
+            slices[sq][soft_pext(b, m.mask)] = m.attacks[m.index(b)];
+            b = (b - m.mask) & m.mask;
+        } while (b);
+    }
+}
+
+bool pextAvailable()
+{
+    return g_pext_ready;
+}
+
+CHESS_TARGET_BMI2 Bitboard pextRookAttacks(int sq, Bitboard occ)
+{
+    return PEXT_ROOK[sq][_pext_u64(occ, ROOK_MAGICS[sq].mask)];
+}
+
+CHESS_TARGET_BMI2 Bitboard pextBishopAttacks(int sq, Bitboard occ)
+{
+    return PEXT_BISHOP[sq][_pext_u64(occ, BISHOP_MAGICS[sq].mask)];
+}
+#endif
+
+bool initMagics()
+{
+    static bool ready = false;
+    if (ready)
+        return true;
+    Bitboard *next = init_slider(ROOK_MAGICS, SLIDER_ATTACKS, true);
+    init_slider(BISHOP_MAGICS, next, false);
+#ifdef CHESS_USE_PEXT
+    if (cpuFeatures().bmi2)
+    {
+        init_pext(ROOK_MAGICS, PEXT_ROOK);
+        init_pext(BISHOP_MAGICS, PEXT_BISHOP);
+        g_pext_ready = true;
+    }
+#endif
+    ready = true;
+    return true;
+}
+
+static const bool MAGICS_READY = initMagics();
@@ -2,15 +2,37 @@
 #include "chess/attacks.hpp"
 #include <cassert>
 #include "chess/zobrist.hpp"
-#include "chess/repetition.hpp"
-#include <vector>
 
-std::stack<MoveHistory> history;
+#ifdef CHESS_VERIFY_INCREMENTAL
+static bool psqConsistent(const Position &pos)
+{
+    int mg, eg, phase;
+    Psqt::compute(pos, mg, eg, phase);
+    return mg == pos.psq_mg && eg == pos.psq_eg && phase == pos.phase;
+}
+#endif
+
+StateStack &defaultStateStack()
+{
+    thread_local StateStack state;
+    return state;
+}
 
 void makeMove(Position &pos, const Move &move)
 {
-    MoveHistory hist;
-    hist.move = move;
+    makeMove(pos, move, defaultStateStack());
+}
+
+void UndoMove(Position &pos)
+{
+    UndoMove(pos, defaultStateStack());
+}
+
+// Applies move to pos and records what UndoMove needs in hist. Shared by the
+// make/undo and copy-make paths.
+static void applyMove(Position &pos, const Move &move, MoveHistory &hist)
+{
+    hist.move = packMove(move);
     hist.moved_piece = getPiece(pos, move.from);
     hist.captured = -1;
     hist.captured_piece = EMPTY;
@@ -18,6 +40,9 @@ void makeMove(Position &pos, const Move &move)
     hist.prev_fullmove = pos.fullmove;
     hist.prev_halfmove = pos.halfmove;
     hist.previous_en_passant = pos.en_passant;
+    hist.prev_zobrist = pos.zobrist;
+    hist.prev_pawn_key = pos.pawn_key;
+    pos.dirty.clear();
 
     if (pos.en_passant != -1)
     {
@@ -25,9 +50,12 @@ void makeMove(Position &pos, const Move &move)
     }
 
     pos.en_passant = -1;
+    const bool pawn_move = hist.moved_piece == WP || hist.moved_piece == BP;
     {
         int x = Zobrist::piece_index(hist.moved_piece);
         pos.zobrist ^= Zobrist::PIECE_SQ[x][move.from];
+        if (pawn_move)
+            pos.pawn_key ^= Zobrist::PIECE_SQ[x][move.from];
     }
 
     removePiece(pos, move.from);
@@ -39,6 +67,7 @@ void makeMove(Position &pos, const Move &move)
         {
             int h = Zobrist::piece_index(hist.captured_piece);
             pos.zobrist ^= Zobrist::PIECE_SQ[h][hist.captured];
+            pos.pawn_key ^= Zobrist::PIECE_SQ[h][hist.captured];
         }
 
         removePiece(pos, hist.captured);
@@ -47,10 +76,14 @@ void makeMove(Position &pos, const Move &move)
     {
         hist.captured_piece = getPiece(pos, move.to);
         hist.captured = move.to;
+        assert(hist.captured_piece != EMPTY && "applyMove: capture flag on an empty square");
 
+        int h = Zobrist::piece_index(hist.captured_piece);
+        if (h >= 0)
         {
-            int h = Zobrist::piece_index(hist.captured_piece);
             pos.zobrist ^= Zobrist::PIECE_SQ[h][move.to];
+            if (hist.captured_piece == WP || hist.captured_piece == BP)
+                pos.pawn_key ^= Zobrist::PIECE_SQ[h][move.to];
         }
 
         removePiece(pos, move.to);
@@ -87,6 +120,8 @@ void makeMove(Position &pos, const Move &move)
         {
             int h = Zobrist::piece_index(hist.moved_piece);
             pos.zobrist ^= Zobrist::PIECE_SQ[h][move.to];
+            if (pawn_move)
+                pos.pawn_key ^= Zobrist::PIECE_SQ[h][move.to];
         }
     }
 
@@ -206,9 +241,8 @@ void makeMove(Position &pos, const Move &move)
         }
     }
 
-    bool pawnMove = (hist.moved_piece == WP || hist.moved_piece == BP);
     bool didCapture = (move.flags & (CAPTURE | EN_PASSANT)) != 0;
-    if (pawnMove || didCapture || (move.flags & PROMOTION))
+    if (pawn_move || didCapture || (move.flags & PROMOTION))
     {
         pos.halfmove = 0;
     }
@@ -233,27 +267,102 @@ void makeMove(Position &pos, const Move &move)
 
     pos.zobrist ^= Zobrist::SIDE;
 
-    rep_push(pos);
+    if (pos.side_to_move == WHITE)
+    {
+        pos.fullmove += 1;
+    }
+
+}
+
+void makeMove(Position &pos, const Move &move, StateStack &state)
+{
+    MoveHistory hist;
+    applyMove(pos, move, hist);
+    state.moves.push_back(hist);
+    state.keys.push_back(pos.zobrist);
+
+#ifdef CHESS_VERIFY_INCREMENTAL
+    assert(pos.zobrist == Zobrist::compute(pos) && "makeMove: incremental zobrist key drifted");
+    assert(pos.pawn_key == Zobrist::computePawnKey(pos) && "makeMove: incremental pawn key drifted");
+    assert(psqConsistent(pos) && "makeMove: incremental eval terms drifted");
+#endif
+}
 
+void makeNullMove(Position &pos, StateStack &state)
+{
+    MoveHistory hist;
+    hist.move = PackedMove{};
+    hist.moved_piece = EMPTY;
+    hist.captured_piece = EMPTY;
+    hist.captured = -1;
+    hist.previous_en_passant = pos.en_passant;
+    hist.prev_castling = pos.castling;
+    hist.prev_halfmove = pos.halfmove;
+    hist.prev_fullmove = pos.fullmove;
+    hist.prev_zobrist = pos.zobrist;
+    hist.prev_pawn_key = pos.pawn_key;
+    pos.dirty.clear();
 
+    if (pos.en_passant != -1)
+    {
+        pos.zobrist ^= Zobrist::EP_FILE[pos.en_passant % 8];
+        pos.en_passant = -1;
+    }
+    pos.halfmove = 0;
+    pos.side_to_move = (pos.side_to_move == WHITE) ? BLACK : WHITE;
+    pos.zobrist ^= Zobrist::SIDE;
     if (pos.side_to_move == WHITE)
     {
         pos.fullmove += 1;
     }
 
-    history.push(hist);
+    state.moves.push_back(hist);
+    state.keys.push_back(pos.zobrist);
+
+#ifdef CHESS_VERIFY_INCREMENTAL
+    assert(pos.zobrist == Zobrist::compute(pos) && "makeNullMove: incremental zobrist key drifted");
+#endif
 }
 
-void UndoMove(Position &pos)
+void undoNullMove(Position &pos, StateStack &state)
 {
-    assert(!history.empty());
-    MoveHistory hist = history.top();
-    history.pop();
-    if ((hist.moved_piece == WK || hist.moved_piece == BK) && std::abs(hist.move.from - hist.move.to) == 2)
+    assert(!state.moves.empty() && state.moves.back().move.isNone());
+    const MoveHistory &hist = state.moves.back();
+    pos.dirty.clear();
+    pos.en_passant = hist.previous_en_passant;
+    pos.halfmove = hist.prev_halfmove;
+    pos.fullmove = hist.prev_fullmove;
+    pos.side_to_move = (pos.side_to_move == WHITE) ? BLACK : WHITE;
+    pos.zobrist = hist.prev_zobrist;
+    state.moves.pop_back();
+    state.keys.pop_back();
+}
+
+Position makeMoveCopy(const Position &pos, const Move &move)
+{
+    Position child = pos;
+    MoveHistory hist;
+    applyMove(child, move, hist);
+
+#ifdef CHESS_VERIFY_INCREMENTAL
+    assert(child.zobrist == Zobrist::compute(child) && "makeMoveCopy: incremental zobrist key drifted");
+    assert(child.pawn_key == Zobrist::computePawnKey(child) && "makeMoveCopy: incremental pawn key drifted");
+#endif
+    return child;
+}
+
+void UndoMove(Position &pos, StateStack &state)
+{
+    assert(!state.moves.empty());
+    MoveHistory hist = state.moves.back();
+    state.moves.pop_back();
+    pos.dirty.clear();
+    const Move move = unpackMove(hist.move);
+    if ((hist.moved_piece == WK || hist.moved_piece == BK) && std::abs(move.from - move.to) == 2)
     {
         if (hist.moved_piece == WK)
         {
-            if (hist.move.to == get_index('g', 1))
+            if (move.to == get_index('g', 1))
             {
                 removePiece(pos, get_index('f', 1));
                 addPiece(pos, get_index('h', 1), WR);
@@ -266,7 +375,7 @@ void UndoMove(Position &pos)
         }
         else
         {
-            if (hist.move.to == get_index('g', 8))
+            if (move.to == get_index('g', 8))
             {
                 removePiece(pos, get_index('f', 8));
                 addPiece(pos, get_index('h', 8), BR);
@@ -279,14 +388,14 @@ void UndoMove(Position &pos)
         }
     }
 
-    removePiece(pos, hist.move.to);
-    if (hist.move.flags & PROMOTION)
+    removePiece(pos, move.to);
+    if (move.flags & PROMOTION)
     {
-        addPiece(pos, hist.move.from, hist.moved_piece);
+        addPiece(pos, move.from, hist.moved_piece);
     }
     else
     {
-        addPiece(pos, hist.move.from, hist.moved_piece);
+        addPiece(pos, move.from, hist.moved_piece);
     }
 
     if (hist.captured_piece != EMPTY)
@@ -299,6 +408,14 @@ void UndoMove(Position &pos)
     pos.fullmove = hist.prev_fullmove;
     pos.side_to_move = (pos.side_to_move == WHITE) ? BLACK : WHITE;
 
-    pos.zobrist = Zobrist::compute(pos);
-    rep_pop();
+    pos.zobrist = hist.prev_zobrist;
+    pos.pawn_key = hist.prev_pawn_key;
+    if (!state.keys.empty())
+        state.keys.pop_back();
+
+#ifdef CHESS_VERIFY_INCREMENTAL
+    assert(pos.zobrist == Zobrist::compute(pos) && "UndoMove: restored zobrist key is wrong");
+    assert(pos.pawn_key == Zobrist::computePawnKey(pos) && "UndoMove: restored pawn key is wrong");
+    assert(psqConsistent(pos) && "UndoMove: restored eval terms are wrong");
+#endif
 }
@@ -75,7 +75,8 @@ Bitboard enPassantFrom(Color col, const Position &pos, int sq)
     return computePawnCapture(col, sq) & convert_to_bit(pos.en_passant);
 }
 
-void generatePawnMoves(const Position &pos, std::vector<Move> &list)
+template <typename List>
+static void pawnMoves(const Position &pos, List &list)
 {
     Bitboard pawns = (pos.side_to_move == WHITE) ? pos.P : pos.p;
     while (pawns)
@@ -128,7 +129,8 @@ void generatePawnMoves(const Position &pos, std::vector<Move> &list)
     }
 }
 
-void generateKnightMoves(const Position &pos, std::vector<Move> &list)
+template <typename List>
+static void knightMoves(const Position &pos, List &list)
 {
     Bitboard knights = (pos.side_to_move == WHITE) ? pos.N : pos.n;
     Bitboard opp = opp_piece(pos, pos.side_to_move);
@@ -152,7 +154,8 @@ void generateKnightMoves(const Position &pos, std::vector<Move> &list)
     }
 }
 
-void generateKingMoves(const Position &pos, std::vector<Move> &list)
+template <typename List>
+static void kingMoves(const Position &pos, List &list)
 {
     Bitboard king = (pos.side_to_move == WHITE) ? pos.K : pos.k;
     Bitboard opp = opp_piece(pos, pos.side_to_move);
@@ -238,7 +241,8 @@ void generateKingMoves(const Position &pos, std::vector<Move> &list)
     }
 }
 
-void generateBishopMoves(const Position &pos, std::vector<Move> &list)
+template <typename List>
+static void bishopMoves(const Position &pos, List &list)
 {
     Bitboard bishops = (pos.side_to_move == WHITE) ? pos.B : pos.b;
     Bitboard opp = opp_piece(pos, pos.side_to_move);
@@ -261,7 +265,8 @@ void generateBishopMoves(const Position &pos, std::vector<Move> &list)
     }
 }
 
-void generateRookMoves(const Position &pos, std::vector<Move> &list)
+template <typename List>
+static void rookMoves(const Position &pos, List &list)
 {
     Bitboard rooks = (pos.side_to_move == WHITE) ? pos.R : pos.r;
     Bitboard opp = opp_piece(pos, pos.side_to_move);
@@ -284,7 +289,8 @@ void generateRookMoves(const Position &pos, std::vector<Move> &list)
     }
 }
 
-void generateQueenMoves(const Position &pos, std::vector<Move> &list)
+template <typename List>
+static void queenMoves(const Position &pos, List &list)
 {
     Bitboard queens = (pos.side_to_move == WHITE) ? pos.Q : pos.q;
     Bitboard opp = opp_piece(pos, pos.side_to_move);
@@ -308,17 +314,18 @@ void generateQueenMoves(const Position &pos, std::vector<Move> &list)
     }
 }
 
-void generateAllMoves(const Position &pos, std::vector<Move> &list)
+template <typename List>
+static void allMoves(const Position &pos, List &list)
 {
-    generatePawnMoves(pos, list);
-    generateKnightMoves(pos, list);
-    generateBishopMoves(pos, list);
-    generateRookMoves(pos, list);
-    generateQueenMoves(pos, list);
-    generateKingMoves(pos, list);
+    pawnMoves(pos, list);
+    knightMoves(pos, list);
+    bishopMoves(pos, list);
+    rookMoves(pos, list);
+    queenMoves(pos, list);
+    kingMoves(pos, list);
 }
 
-void generateLegalAllMoves(Position &pos, std::vector<Move> &final)
+void generateLegalAllMovesMakeUndo(Position &pos, std::vector<Move> &final)
 {
     std::vector<Move> temp;
     generateAllMoves(pos, temp);
@@ -334,3 +341,368 @@ void generateLegalAllMoves(Position &pos, std::vector<Move> &final)
         UndoMove(pos);
     }
 }
+
+// Per-node legality information, computed once before any move is emitted.
+struct LegalInfo
+{
+    int king;
+    Bitboard checkers;
+    Bitboard check_mask; // where a non-king move must land (all squares if not in check)
+    Bitboard pinned;
+    Bitboard pin_ray[64]; // only valid for squares in pinned
+    Bitboard danger;      // squares the enemy attacks with our king lifted off the board
+};
+
+static Bitboard enemyAttacks(const Position &pos, Color them, Bitboard occ)
+{
+    bool white = them == WHITE;
+    Bitboard pawns = white ? pos.P : pos.p;
+    Bitboard attacked = white ? (shift_northeast(pawns) | shift_northwest(pawns))
+                              : (shift_southeast(pawns) | shift_southwest(pawns));
+
+    Bitboard knights = white ? pos.N : pos.n;
+    while (knights)
+        attacked |= KNIGHT_TABLE[pop_lsb(knights)];
+
+    Bitboard diag = white ? (pos.B | pos.Q) : (pos.b | pos.q);
+    while (diag)
+        attacked |= computeBishopMove(pop_lsb(diag), occ);
+
+    Bitboard orth = white ? (pos.R | pos.Q) : (pos.r | pos.q);
+    while (orth)
+        attacked |= computeRookMove(pop_lsb(orth), occ);
+
+    attacked |= KING_TABLE[kingSquare(them, pos)];
+    return attacked;
+}
+
+static void computeLegalInfo(const Position &pos, LegalInfo &info)
+{
+    Color us = pos.side_to_move;
+    Color them = (us == WHITE) ? BLACK : WHITE;
+    bool white = us == WHITE;
+    Bitboard occ = pos.total_pieces;
+    Bitboard ours = ally_piece(pos, us);
+    Bitboard theirs = opp_piece(pos, us);
+    Bitboard their_diag = white ? (pos.b | pos.q) : (pos.B | pos.Q);
+    Bitboard their_orth = white ? (pos.r | pos.q) : (pos.R | pos.Q);
+
+    info.king = kingSquare(us, pos);
+    int k = info.king;
+
+    info.checkers = (PAWN_CAPTURE_TABLE[us][k] & (white ? pos.p : pos.P)) |
+                    (KNIGHT_TABLE[k] & (white ? pos.n : pos.N)) |
+                    (computeBishopMove(k, occ) & their_diag) |
+                    (computeRookMove(k, occ) & their_orth);
+
+    info.check_mask = ~0ULL;
+    if (info.checkers)
+    {
+        int c = peek_lsb(info.checkers);
+        info.check_mask = info.checkers | BETWEEN_TABLE[k][c];
+    }
+
+    // Sliders that would hit the king if our own pieces were transparent; a
+    // single friendly piece in between is pinned to that segment.
+    info.pinned = 0;
+    Bitboard snipers = (computeBishopMove(k, theirs) & their_diag) |
+                       (computeRookMove(k, theirs) & their_orth);
+    while (snipers)
+    {
+        int s = pop_lsb(snipers);
+        Bitboard between = BETWEEN_TABLE[k][s] & occ;
+        if (between && (between & (between - 1)) == 0 && (between & ours))
+        {
+            int sq = peek_lsb(between);
+            info.pinned |= between;
+            info.pin_ray[sq] = BETWEEN_TABLE[k][s] | convert_to_bit(s);
+        }
+    }
+
+    info.danger = enemyAttacks(pos, them, occ & ~convert_to_bit(k));
+}
+
+static inline Bitboard legalTargets(const LegalInfo &info, int from)
+{
+    return is_Piece(info.pinned, from) ? (info.check_mask & info.pin_ray[from]) : info.check_mask;
+}
+
+// Which half of the legal moves a generator emits. Noisy is captures, en
+// passant and every promotion; Quiet is the rest, castling included.
+enum class GenType
+{
+    All,
+    Noisy,
+    Quiet
+};
+
+template <GenType Type, typename List>
+static void pushTargets(List &list, int from, Bitboard targets, Bitboard opp)
+{
+    Bitboard captures = Type == GenType::Quiet ? 0 : targets & opp;
+    Bitboard normal = Type == GenType::Noisy ? 0 : targets & ~opp;
+    while (captures)
+    {
+        int to = pop_lsb(captures);
+        list.push_back({from, to, CAPTURE, NO_PROMO, -1});
+    }
+    while (normal)
+    {
+        int to = pop_lsb(normal);
+        list.push_back({from, to, 0, NO_PROMO, -1});
+    }
+}
+
+template <typename List>
+static void pushPromotions(List &list, int from, int to, uint16_t flags)
+{
+    list.push_back({from, to, flags, PROMO_Q, -1});
+    list.push_back({from, to, flags, PROMO_R, -1});
+    list.push_back({from, to, flags, PROMO_B, -1});
+    list.push_back({from, to, flags, PROMO_N, -1});
+}
+
+// En passant removes two pawns from one rank, which can expose the king to a
+// slider in a way the pin mask cannot see, so it is checked directly.
+static bool enPassantLegal(const Position &pos, const LegalInfo &info, int from, int to, int captured)
+{
+    bool white = pos.side_to_move == WHITE;
+    if (info.checkers && !is_Piece(info.checkers, captured) && !is_Piece(info.check_mask, to))
+        return false;
+    Bitboard occ = (pos.total_pieces & ~convert_to_bit(from) & ~convert_to_bit(captured)) | convert_to_bit(to);
+    Bitboard their_diag = white ? (pos.b | pos.q) : (pos.B | pos.Q);
+    Bitboard their_orth = white ? (pos.r | pos.q) : (pos.R | pos.Q);
+    return (computeBishopMove(info.king, occ) & their_diag) == 0 &&
+           (computeRookMove(info.king, occ) & their_orth) == 0;
+}
+
+template <GenType Type, typename List>
+static void generateLegalPawnMoves(const Position &pos, const LegalInfo &info, List &list, Bitboard from_mask)
+{
+    Color us = pos.side_to_move;
+    Bitboard pawns = ((us == WHITE) ? pos.P : pos.p) & from_mask;
+    while (pawns)
+    {
+        int from = pop_lsb(pawns);
+        Bitboard allowed = legalTargets(info, from);
+
+        if (Type != GenType::Noisy)
+        {
+            if (Bitboard single = PawnSinglePushTo(us, pos, from) & allowed)
+                list.push_back({from, peek_lsb(single), 0, NO_PROMO, -1});
+
+            if (Bitboard doub = PawnDoublePushTo(us, pos, from) & allowed)
+                list.push_back({from, peek_lsb(doub), DOUBLE_PUSH, NO_PROMO, -1});
+        }
+        if (Type == GenType::Quiet)
+            continue;
+
+        Bitboard promoPush = PawnPromoPushTo(us, pos, from) & allowed;
+        while (promoPush)
+            pushPromotions(list, from, pop_lsb(promoPush), PROMOTION);
+
+        Bitboard captures = PawnCapturesNormalTo(us, pos, from) & allowed;
+        while (captures)
+            list.push_back({from, pop_lsb(captures), CAPTURE, NO_PROMO, -1});
+
+        Bitboard promoCaptures = PawnCapturesPromotionTo(us, pos, from) & allowed;
+        while (promoCaptures)
+            pushPromotions(list, from, pop_lsb(promoCaptures), CAPTURE | PROMOTION);
+
+        if (enPassantFrom(us, pos, from))
+        {
+            int to = pos.en_passant;
+            int captured = (us == WHITE) ? to - 8 : to + 8;
+            bool on_pin_ray = !is_Piece(info.pinned, from) || is_Piece(info.pin_ray[from], to);
+            if (on_pin_ray && enPassantLegal(pos, info, from, to, captured))
+                list.push_back({from, to, EN_PASSANT, NO_PROMO, -1});
+        }
+    }
+}
+
+template <GenType Type, typename List>
+static void generateLegalPieceMoves(const Position &pos, const LegalInfo &info, List &list, Bitboard from_mask)
+{
+    Color us = pos.side_to_move;
+    bool white = us == WHITE;
+    Bitboard ours = ally_piece(pos, us);
+    Bitboard opp = opp_piece(pos, us);
+    Bitboard occ = pos.total_pieces;
+
+    Bitboard knights = (white ? pos.N : pos.n) & ~info.pinned & from_mask;
+    while (knights)
+    {
+        int from = pop_lsb(knights);
+        pushTargets<Type>(list, from, KNIGHT_TABLE[from] & ~ours & info.check_mask, opp);
+    }
+
+    Bitboard bishops = (white ? pos.B : pos.b) & from_mask;
+    while (bishops)
+    {
+        int from = pop_lsb(bishops);
+        pushTargets<Type>(list, from, computeBishopMove(from, occ) & ~ours & legalTargets(info, from), opp);
+    }
+
+    Bitboard rooks = (white ? pos.R : pos.r) & from_mask;
+    while (rooks)
+    {
+        int from = pop_lsb(rooks);
+        pushTargets<Type>(list, from, computeRookMove(from, occ) & ~ours & legalTargets(info, from), opp);
+    }
+
+    Bitboard queens = (white ? pos.Q : pos.q) & from_mask;
+    while (queens)
+    {
+        int from = pop_lsb(queens);
+        pushTargets<Type>(list, from, computeQueenMove(from, occ) & ~ours & legalTargets(info, from), opp);
+    }
+}
+
+template <GenType Type, typename List>
+static void generateLegalKingMoves(const Position &pos, const LegalInfo &info, List &list)
+{
+    Color us = pos.side_to_move;
+    int from = info.king;
+    pushTargets<Type>(list, from, KING_TABLE[from] & ~ally_piece(pos, us) & ~info.danger, opp_piece(pos, us));
+
+    if (info.checkers || Type == GenType::Noisy)
+        return;
+
+    // The king's own square is already known to be safe (no checkers).
+    Bitboard occ = pos.total_pieces;
+    if (us == WHITE)
+    {
+        if ((pos.castling & White_King) && is_Piece(pos.R, get_index('h', 1)) &&
+            (occ & 0x60ULL) == 0 && (info.danger & 0x60ULL) == 0)
+            list.push_back({from, get_index('g', 1), 0, NO_PROMO, -1});
+        if ((pos.castling & White_Queen) && is_Piece(pos.R, get_index('a', 1)) &&
+            (occ & 0x0EULL) == 0 && (info.danger & 0x0CULL) == 0)
+            list.push_back({from, get_index('c', 1), 0, NO_PROMO, -1});
+    }
+    else
+    {
+        if ((pos.castling & Black_King) && is_Piece(pos.r, get_index('h', 8)) &&
+            (occ & (0x60ULL << 56)) == 0 && (info.danger & (0x60ULL << 56)) == 0)
+            list.push_back({from, get_index('g', 8), 0, NO_PROMO, -1});
+        if ((pos.castling & Black_Queen) && is_Piece(pos.r, get_index('a', 8)) &&
+            (occ & (0x0EULL << 56)) == 0 && (info.danger & (0x0CULL << 56)) == 0)
+            list.push_back({from, get_index('c', 8), 0, NO_PROMO, -1});
+    }
+}
+
+// from_mask limits generation to the pieces standing on it.
+template <GenType Type = GenType::All, typename List>
+static void legalMoves(const Position &pos, List &list, Bitboard from_mask = ~0ULL)
+{
+    LegalInfo info;
+    computeLegalInfo(pos, info);
+
+    // Double check: only the king can move.
+    if ((info.checkers & (info.checkers - 1)) == 0)
+    {
+        generateLegalPawnMoves<Type>(pos, info, list, from_mask);
+        generateLegalPieceMoves<Type>(pos, info, list, from_mask);
+    }
+    if (is_Piece(from_mask, info.king))
+        generateLegalKingMoves<Type>(pos, info, list);
+}
+
+void generatePawnMoves(const Position &pos, std::vector<Move> &list) { pawnMoves(pos, list); }
+void generateKnightMoves(const Position &pos, std::vector<Move> &list) { knightMoves(pos, list); }
+void generateKingMoves(const Position &pos, std::vector<Move> &list) { kingMoves(pos, list); }
+void generateBishopMoves(const Position &pos, std::vector<Move> &list) { bishopMoves(pos, list); }
+void generateRookMoves(const Position &pos, std::vector<Move> &list) { rookMoves(pos, list); }
+void generateQueenMoves(const Position &pos, std::vector<Move> &list) { queenMoves(pos, list); }
+void generateAllMoves(const Position &pos, std::vector<Move> &list) { allMoves(pos, list); }
+void generateLegalMoves(const Position &pos, std::vector<Move> &list) { legalMoves(pos, list); }
+void generateLegalAllMoves(Position &pos, std::vector<Move> &final) { legalMoves(pos, final); }
+
+void generatePawnMoves(const Position &pos, MoveList &list) { pawnMoves(pos, list); }
+void generateKnightMoves(const Position &pos, MoveList &list) { knightMoves(pos, list); }
+void generateKingMoves(const Position &pos, MoveList &list) { kingMoves(pos, list); }
+void generateBishopMoves(const Position &pos, MoveList &list) { bishopMoves(pos, list); }
+void generateRookMoves(const Position &pos, MoveList &list) { rookMoves(pos, list); }
+void generateQueenMoves(const Position &pos, MoveList &list) { queenMoves(pos, list); }
+void generateAllMoves(const Position &pos, MoveList &list) { allMoves(pos, list); }
+void generateLegalMoves(const Position &pos, MoveList &list) { legalMoves(pos, list); }
+void generateLegalAllMoves(Position &pos, MoveList &final) { legalMoves(pos, final); }
+void generateLegalCaptures(const Position &pos, MoveList &list) { legalMoves<GenType::Noisy>(pos, list); }
+void generateLegalQuiets(const Position &pos, MoveList &list) { legalMoves<GenType::Quiet>(pos, list); }
+
+// Cheapest and most often successful pieces first: a king step is one table
+// lookup, and castling never needs a look of its own, since it is only legal
+// when the king could also step to the square it passes. A double check
+// leaves nothing else to try.
+bool hasLegalMove(const Position &pos)
+{
+    LegalInfo info;
+    computeLegalInfo(pos, info);
+    Color us = pos.side_to_move;
+    bool white = us == WHITE;
+    Bitboard ours = ally_piece(pos, us);
+    Bitboard opp = opp_piece(pos, us);
+    Bitboard occ = pos.total_pieces;
+
+    if (KING_TABLE[info.king] & ~ours & ~info.danger)
+        return true;
+    if (info.checkers & (info.checkers - 1))
+        return false;
+
+    Bitboard knights = (white ? pos.N : pos.n) & ~info.pinned;
+    while (knights)
+    {
+        if (KNIGHT_TABLE[pop_lsb(knights)] & ~ours & info.check_mask)
+            return true;
+    }
+
+    Bitboard pawns = white ? pos.P : pos.p;
+    while (pawns)
+    {
+        int from = pop_lsb(pawns);
+        Bitboard bit = convert_to_bit(from);
+        // One step onto any rank, promotions included.
+        Bitboard targets = ((white ? shift_north(bit) : shift_south(bit)) & ~occ) |
+                           PawnDoublePushTo(us, pos, from) | (computePawnCapture(us, from) & opp);
+        if (targets & legalTargets(info, from))
+            return true;
+        if (enPassantFrom(us, pos, from))
+        {
+            int to = pos.en_passant;
+            int captured = white ? to - 8 : to + 8;
+            bool on_pin_ray = !is_Piece(info.pinned, from) || is_Piece(info.pin_ray[from], to);
+            if (on_pin_ray && enPassantLegal(pos, info, from, to, captured))
+                return true;
+        }
+    }
+
+    Bitboard diag = white ? (pos.B | pos.Q) : (pos.b | pos.q);
+    while (diag)
+    {
+        int from = pop_lsb(diag);
+        if (computeBishopMove(from, occ) & ~ours & legalTargets(info, from))
+            return true;
+    }
+    Bitboard orth = white ? (pos.R | pos.Q) : (pos.r | pos.q);
+    while (orth)
+    {
+        int from = pop_lsb(orth);
+        if (computeRookMove(from, occ) & ~ours & legalTargets(info, from))
+            return true;
+    }
+    return false;
+}
+
+bool isLegalMove(const Position &pos, PackedMove move)
+{
+    if (move.isNone() || !is_Piece(ally_piece(pos, pos.side_to_move), move.from()))
+        return false;
+    MoveList list;
+    legalMoves(pos, list, convert_to_bit(move.from()));
+    for (const Move &m : list)
+        if (packMove(m) == move)
+            return true;
+    return false;
+}
+
+void generateAllMoves(const Position &pos, PackedMoveList &list) { allMoves(pos, list); }
+void generateLegalMoves(const Position &pos, PackedMoveList &list) { legalMoves(pos, list); }
@@ -0,0 +1,225 @@
+#include "chess/movepick.hpp"
+#include "chess/movegen.hpp"
+#include "chess/eval.hpp"
+#include "chess/see.hpp"
+#include <algorithm>
+
+namespace
+{
+// Only quiet and double-push kinds can be killers; anything else is emitted
+// by the capture stage already.
+bool isQuietKind(PackedMove m)
+{
+    return m.kind() == KIND_QUIET || m.kind() == KIND_DOUBLE_PUSH;
+}
+
+// A knight, bishop or rook promotion that captures nothing: left to the
+// main search, since it almost never beats the queen promotion beside it.
+bool isQuietUnderpromotion(const Move &m)
+{
+    return (m.flags & PROMOTION) && !(m.flags & CAPTURE) && m.promo != PROMO_Q;
+}
+} // namespace
+
+MovePicker::MovePicker(const Position &p, PackedMove first_move, const PackedMove *killer_moves,
+                       const HistoryTable &h)
+    : pos(p), history(&h), first(first_move), stage(STAGE_FIRST)
+{
+    if (killer_moves)
+    {
+        killers[0] = killer_moves[0];
+        killers[1] = killer_moves[1];
+    }
+}
+
+MovePicker::MovePicker(const Position &p) : pos(p), stage(STAGE_QS_INIT)
+{
+}
+
+MovePicker::MovePicker(const Position &p, Unordered) : pos(p), stage(STAGE_UNORDERED_INIT)
+{
+}
+
+// Most valuable victim, then least valuable attacker; a promotion counts as
+// capturing the piece it promotes to.
+void MovePicker::scoreCaptures(int begin, int end_index)
+{
+    for (int i = begin; i < end_index; i++)
+    {
+        const Move &m = moves[i];
+        int victim = (m.flags & EN_PASSANT) ? PIECE_VALUE[WP] : PIECE_VALUE[pos.board[m.to]];
+        if (m.flags & PROMOTION)
+            victim += PIECE_VALUE[WP + m.promo];
+        scores[i] = victim * 8 - PIECE_VALUE[pos.board[m.from]] / 100;
+    }
+}
+
+void MovePicker::scoreQuiets(int begin, int end_index)
+{
+    for (int i = begin; i < end_index; i++)
+        scores[i] = history->get(pos.side_to_move, packMove(moves[i]));
+}
+
+// Selection step: swaps the best of [begin, end) into begin. Cheaper than a
+// full sort when a cutoff comes after a few moves, which is the usual case.
+void MovePicker::pickBest(int begin, int end_index)
+{
+    int best = begin;
+    for (int j = begin + 1; j < end_index; j++)
+        if (scores[j] > scores[best])
+            best = j;
+    if (best != begin)
+    {
+        std::swap(moves.moves[begin], moves.moves[best]);
+        std::swap(scores[begin], scores[best]);
+    }
+}
+
+bool MovePicker::isSpecial(PackedMove m) const
+{
+    return (!first.isNone() && m == first) || (!killers[0].isNone() && m == killers[0]) ||
+           (!killers[1].isNone() && m == killers[1]);
+}
+
+bool MovePicker::next(Move &out)
+{
+    while (true)
+    {
+        switch (stage)
+        {
+        case STAGE_FIRST:
+            stage = STAGE_INIT_CAPTURES;
+            if (isLegalMove(pos, first))
+            {
+                out = unpackMove(first);
+                last_stage = STAGE_FIRST;
+                return true;
+            }
+            first = PackedMove{};
+            break;
+
+        case STAGE_INIT_CAPTURES:
+            generateLegalCaptures(pos, moves);
+            end = moves.count;
+            scoreCaptures(0, end);
+            stage = STAGE_GOOD_CAPTURES;
+            break;
+
+        case STAGE_GOOD_CAPTURES:
+            while (cur < end)
+            {
+                pickBest(cur, end);
+                const Move m = moves[cur];
+                if (!first.isNone() && packMove(m) == first)
+                {
+                    cur++;
+                    continue;
+                }
+                // Losing captures wait at the front of the list; the slot
+                // they take holds a move that has already been returned.
+                if (!seeAtLeast(pos, m, 0))
+                {
+                    std::swap(moves.moves[bad_end++], moves.moves[cur++]);
+                    continue;
+                }
+                cur++;
+                out = m;
+                last_stage = STAGE_GOOD_CAPTURES;
+                return true;
+            }
+            stage = STAGE_KILLERS;
+            break;
+
+        case STAGE_KILLERS:
+            while (killer_index < 2)
+            {
+                PackedMove &k = killers[killer_index++];
+                if (k.isNone() || k == first || !isQuietKind(k) || !isLegalMove(pos, k))
+                {
+                    k = PackedMove{};
+                    continue;
+                }
+                out = unpackMove(k);
+                last_stage = STAGE_KILLERS;
+                return true;
+            }
+            stage = STAGE_INIT_QUIETS;
+            break;
+
+        case STAGE_INIT_QUIETS:
+            cur = end;
+            generateLegalQuiets(pos, moves);
+            end = moves.count;
+            scoreQuiets(cur, end);
+            stage = STAGE_QUIETS;
+            break;
+
+        case STAGE_QUIETS:
+            while (cur < end)
+            {
+                pickBest(cur, end);
+                const Move m = moves[cur++];
+                if (isSpecial(packMove(m)))
+                    continue;
+                out = m;
+                last_stage = STAGE_QUIETS;
+                return true;
+            }
+            stage = STAGE_BAD_CAPTURES;
+            break;
+
+        case STAGE_BAD_CAPTURES:
+            if (bad_cur < bad_end)
+            {
+                out = moves[bad_cur++];
+                last_stage = STAGE_BAD_CAPTURES;
+                return true;
+            }
+            stage = STAGE_DONE;
+            break;
+
+        case STAGE_QS_INIT:
+            generateLegalCaptures(pos, moves);
+            for (const Move &m : moves)
+                if (!isQuietUnderpromotion(m))
+                    moves[end++] = m;
+            moves.count = end;
+            scoreCaptures(0, end);
+            stage = STAGE_QS_CAPTURES;
+            break;
+
+        case STAGE_QS_CAPTURES:
+            while (cur < end)
+            {
+                pickBest(cur, end);
+                const Move m = moves[cur++];
+                if (!seeAtLeast(pos, m, 0))
+                    continue;
+                out = m;
+                last_stage = STAGE_QS_CAPTURES;
+                return true;
+            }
+            stage = STAGE_DONE;
+            break;
+
+        case STAGE_UNORDERED_INIT:
+            generateLegalMoves(pos, moves);
+            end = moves.count;
+            stage = STAGE_UNORDERED;
+            break;
+
+        case STAGE_UNORDERED:
+            if (cur < end)
+            {
+                out = moves[cur++];
+                last_stage = STAGE_UNORDERED;
+                return true;
+            }
+            stage = STAGE_DONE;
+            break;
+
+        case STAGE_DONE:
+            return false;
+        }
+    }
+}
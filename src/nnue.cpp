@@ -0,0 +1,549 @@
+#include "chess/nnue.hpp"
+#include "chess/attacks.hpp"
+#include "chess/bitboard.hpp"
+#include "chess/cpu.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef CHESS_USE_SIMD
+#include <immintrin.h>
+#if defined(__GNUC__) || defined(__clang__)
+#define CHESS_TARGET_SSE41 __attribute__((target("sse4.1")))
+#define CHESS_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define CHESS_TARGET_SSE41
+#define CHESS_TARGET_AVX2
+#endif
+#endif
+
+namespace Nnue
+{
+
+namespace
+{
+
+constexpr char MAGIC[4] = {'C', 'N', 'U', 'E'};
+constexpr std::uint32_t VERSION = 1;
+constexpr std::size_t SECTION_ALIGN = 64;
+constexpr std::size_t HEADER_SIZE = 20;
+
+std::size_t alignUp(std::size_t n)
+{
+    return (n + SECTION_ALIGN - 1) / SECTION_ALIGN * SECTION_ALIGN;
+}
+
+std::uint32_t readU32(const unsigned char *p)
+{
+    return static_cast<std::uint32_t>(p[0]) | static_cast<std::uint32_t>(p[1]) << 8 |
+           static_cast<std::uint32_t>(p[2]) << 16 | static_cast<std::uint32_t>(p[3]) << 24;
+}
+
+void setError(std::string *error, const std::string &message)
+{
+    if (error)
+        *error = message;
+}
+
+// Maps path read-only. Returns null on failure.
+void *mapFile(const std::string &path, std::size_t &size)
+{
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+        return nullptr;
+    LARGE_INTEGER file_size;
+    void *view = nullptr;
+    if (GetFileSizeEx(file, &file_size) && file_size.QuadPart > 0)
+    {
+        HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping)
+        {
+            view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping); // the view keeps the mapping alive
+        }
+        size = static_cast<std::size_t>(file_size.QuadPart);
+    }
+    CloseHandle(file);
+    return view;
+#else
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return nullptr;
+    struct stat st;
+    void *view = nullptr;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+    {
+        view = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        if (view == MAP_FAILED)
+            view = nullptr;
+        size = static_cast<std::size_t>(st.st_size);
+    }
+    close(fd);
+    return view;
+#endif
+}
+
+void unmapFile(void *view, std::size_t size)
+{
+#if defined(_WIN32)
+    (void)size;
+    UnmapViewOfFile(view);
+#else
+    munmap(view, size);
+#endif
+}
+
+// ---- Dense layers ----
+//
+// The first dense layer's input is both accumulator halves clipped to
+// [0, ACT_MAX] as bytes, side to move first. Each kernel produces the raw
+// hidden sums; finish() does the rest, which is too small to vectorise.
+
+constexpr int INPUT_SIZE = 2 * ACC_SIZE;
+
+int finish(const Network &net, const std::int32_t *sums)
+{
+    std::int32_t out = net.output_bias;
+    for (int j = 0; j < HIDDEN_SIZE; j++)
+    {
+        int h = std::clamp(sums[j] >> HIDDEN_SHIFT, 0, ACT_MAX);
+        out += net.output_weights[j] * h;
+    }
+    return out / OUTPUT_SCALE;
+}
+
+void hiddenScalar(const Network &net, const std::int16_t *us, const std::int16_t *them, std::int32_t *sums)
+{
+    std::uint8_t input[INPUT_SIZE];
+    for (int i = 0; i < ACC_SIZE; i++)
+    {
+        input[i] = static_cast<std::uint8_t>(std::clamp<int>(us[i], 0, ACT_MAX));
+        input[ACC_SIZE + i] = static_cast<std::uint8_t>(std::clamp<int>(them[i], 0, ACT_MAX));
+    }
+    for (int j = 0; j < HIDDEN_SIZE; j++)
+    {
+        const std::int8_t *row = net.hidden_weights + j * INPUT_SIZE;
+        std::int32_t sum = net.hidden_bias[j];
+        for (int i = 0; i < INPUT_SIZE; i++)
+            sum += row[i] * input[i];
+        sums[j] = sum;
+    }
+}
+
+#ifdef CHESS_USE_SIMD
+static_assert(ACC_SIZE % 32 == 0, "the SIMD kernels take the accumulator 32 values at a time");
+
+// Unsigned input bytes times signed weight bytes, summed in adjacent pairs
+// (maddubs, at most 2 * 127 * 128, so no saturation) and then in fours
+// (madd with ones) into int32 lanes.
+CHESS_TARGET_SSE41 int hsum128(__m128i v)
+{
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return _mm_cvtsi128_si32(v);
+}
+
+CHESS_TARGET_SSE41 void hiddenSse41(const Network &net, const std::int16_t *us, const std::int16_t *them,
+                                    std::int32_t *sums)
+{
+    constexpr int CHUNKS = INPUT_SIZE / 16;
+    const __m128i act_max = _mm_set1_epi8(ACT_MAX);
+    const __m128i ones = _mm_set1_epi16(1);
+    __m128i input[CHUNKS];
+    for (int half = 0; half < 2; half++)
+    {
+        const std::int16_t *acc = half == 0 ? us : them;
+        for (int c = 0; c < ACC_SIZE / 16; c++)
+        {
+            __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(acc + 16 * c));
+            __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(acc + 16 * c + 8));
+            // packus clips below at 0; the minimum clips above.
+            input[half * (ACC_SIZE / 16) + c] = _mm_min_epu8(_mm_packus_epi16(lo, hi), act_max);
+        }
+    }
+    for (int j = 0; j < HIDDEN_SIZE; j++)
+    {
+        const std::int8_t *row = net.hidden_weights + j * INPUT_SIZE;
+        __m128i sum = _mm_setzero_si128();
+        for (int c = 0; c < CHUNKS; c++)
+        {
+            __m128i w = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + 16 * c));
+            sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_maddubs_epi16(input[c], w), ones));
+        }
+        sums[j] = net.hidden_bias[j] + hsum128(sum);
+    }
+}
+
+CHESS_TARGET_AVX2 void hiddenAvx2(const Network &net, const std::int16_t *us, const std::int16_t *them,
+                                  std::int32_t *sums)
+{
+    constexpr int CHUNKS = INPUT_SIZE / 32;
+    const __m256i act_max = _mm256_set1_epi8(ACT_MAX);
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i input[CHUNKS];
+    for (int half = 0; half < 2; half++)
+    {
+        const std::int16_t *acc = half == 0 ? us : them;
+        for (int c = 0; c < ACC_SIZE / 32; c++)
+        {
+            __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(acc + 32 * c));
+            __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(acc + 32 * c + 16));
+            // packus works within 128-bit lanes; the permute puts the
+            // 64-bit quarters back in order.
+            __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi), _MM_SHUFFLE(3, 1, 2, 0));
+            input[half * (ACC_SIZE / 32) + c] = _mm256_min_epu8(packed, act_max);
+        }
+    }
+    for (int j = 0; j < HIDDEN_SIZE; j++)
+    {
+        const std::int8_t *row = net.hidden_weights + j * INPUT_SIZE;
+        __m256i sum = _mm256_setzero_si256();
+        for (int c = 0; c < CHUNKS; c++)
+        {
+            __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(row + 32 * c));
+            sum = _mm256_add_epi32(sum, _mm256_madd_epi16(_mm256_maddubs_epi16(input[c], w), ones));
+        }
+        __m128i folded = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+        sums[j] = net.hidden_bias[j] + hsum128(folded);
+    }
+}
+#endif
+
+// ---- Accumulator updates ----
+//
+// out = in + the rows in add - the rows in sub, with the running sum kept
+// in registers rather than written back after every row.
+
+struct RowChanges
+{
+    static constexpr int MAX_ADD = 32; // a full board
+    const std::int16_t *add[MAX_ADD];
+    const std::int16_t *sub[DirtyPieces::MAX];
+    int add_count = 0;
+    int sub_count = 0;
+};
+
+void updateScalar(const std::int16_t *in, std::int16_t *out, const RowChanges &rows)
+{
+    std::int16_t sum[ACC_SIZE];
+    std::memcpy(sum, in, sizeof(sum));
+    for (int r = 0; r < rows.add_count; r++)
+        for (int i = 0; i < ACC_SIZE; i++)
+            sum[i] += rows.add[r][i];
+    for (int r = 0; r < rows.sub_count; r++)
+        for (int i = 0; i < ACC_SIZE; i++)
+            sum[i] -= rows.sub[r][i];
+    std::memcpy(out, sum, sizeof(sum));
+}
+
+#ifdef CHESS_USE_SIMD
+CHESS_TARGET_SSE41 void updateSse41(const std::int16_t *in, std::int16_t *out, const RowChanges &rows)
+{
+    constexpr int REGS = ACC_SIZE / 8;
+    __m128i sum[REGS];
+    for (int k = 0; k < REGS; k++)
+        sum[k] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + 8 * k));
+    for (int r = 0; r < rows.add_count; r++)
+        for (int k = 0; k < REGS; k++)
+            sum[k] = _mm_add_epi16(sum[k], _mm_loadu_si128(reinterpret_cast<const __m128i *>(rows.add[r] + 8 * k)));
+    for (int r = 0; r < rows.sub_count; r++)
+        for (int k = 0; k < REGS; k++)
+            sum[k] = _mm_sub_epi16(sum[k], _mm_loadu_si128(reinterpret_cast<const __m128i *>(rows.sub[r] + 8 * k)));
+    for (int k = 0; k < REGS; k++)
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + 8 * k), sum[k]);
+}
+
+CHESS_TARGET_AVX2 void updateAvx2(const std::int16_t *in, std::int16_t *out, const RowChanges &rows)
+{
+    constexpr int REGS = ACC_SIZE / 16;
+    __m256i sum[REGS];
+    for (int k = 0; k < REGS; k++)
+        sum[k] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(in + 16 * k));
+    for (int r = 0; r < rows.add_count; r++)
+        for (int k = 0; k < REGS; k++)
+            sum[k] = _mm256_add_epi16(sum[k],
+                                      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rows.add[r] + 16 * k)));
+    for (int r = 0; r < rows.sub_count; r++)
+        for (int k = 0; k < REGS; k++)
+            sum[k] = _mm256_sub_epi16(sum[k],
+                                      _mm256_loadu_si256(reinterpret_cast<const __m256i *>(rows.sub[r] + 16 * k)));
+    for (int k = 0; k < REGS; k++)
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(out + 16 * k), sum[k]);
+}
+#endif
+
+void applyRows(const std::int16_t *in, std::int16_t *out, const RowChanges &rows)
+{
+    switch (bestSimd())
+    {
+#ifdef CHESS_USE_SIMD
+    case Simd::Avx2:
+        updateAvx2(in, out, rows);
+        break;
+    case Simd::Sse41:
+        updateSse41(in, out, rows);
+        break;
+#endif
+    default:
+        updateScalar(in, out, rows);
+        break;
+    }
+}
+
+const std::int16_t *featureRow(const Network &net, int index)
+{
+    return net.ft_weights + static_cast<std::size_t>(index) * ACC_SIZE;
+}
+
+} // namespace
+
+// ---- Network ----
+
+Network::~Network()
+{
+    unload();
+}
+
+void Network::unload()
+{
+    if (map)
+        unmapFile(map, map_size);
+    map = nullptr;
+    map_size = 0;
+    ft_bias = ft_weights = nullptr;
+    hidden_bias = nullptr;
+    hidden_weights = output_weights = nullptr;
+    output_bias = 0;
+}
+
+bool Network::load(const std::string &path, std::string *error)
+{
+    unload();
+    std::size_t size = 0;
+    void *view = mapFile(path, size);
+    if (!view)
+    {
+        setError(error, "cannot open or map " + path);
+        return false;
+    }
+
+    const std::size_t ft_bias_at = alignUp(HEADER_SIZE);
+    const std::size_t ft_weights_at = ft_bias_at + alignUp(ACC_SIZE * sizeof(std::int16_t));
+    const std::size_t hidden_bias_at =
+        ft_weights_at + alignUp(static_cast<std::size_t>(FEATURES) * ACC_SIZE * sizeof(std::int16_t));
+    const std::size_t hidden_weights_at = hidden_bias_at + alignUp(HIDDEN_SIZE * sizeof(std::int32_t));
+    const std::size_t output_bias_at = hidden_weights_at + alignUp(HIDDEN_SIZE * INPUT_SIZE);
+    const std::size_t output_weights_at = output_bias_at + alignUp(sizeof(std::int32_t));
+    const std::size_t expected_size = output_weights_at + alignUp(HIDDEN_SIZE);
+
+    const unsigned char *bytes = static_cast<const unsigned char *>(view);
+    std::string problem;
+    if (size < HEADER_SIZE || std::memcmp(bytes, MAGIC, sizeof(MAGIC)) != 0)
+        problem = "not a network file";
+    else if (readU32(bytes + 4) != VERSION)
+        problem = "unsupported network version " + std::to_string(readU32(bytes + 4));
+    else if (readU32(bytes + 8) != FEATURES || readU32(bytes + 12) != ACC_SIZE || readU32(bytes + 16) != HIDDEN_SIZE)
+        problem = "network dimensions do not match this build";
+    else if (size != expected_size)
+        problem = "network file is " + std::to_string(size) + " bytes, expected " + std::to_string(expected_size);
+    if (!problem.empty())
+    {
+        unmapFile(view, size);
+        setError(error, path + ": " + problem);
+        return false;
+    }
+
+    map = view;
+    map_size = size;
+    ft_bias = reinterpret_cast<const std::int16_t *>(bytes + ft_bias_at);
+    ft_weights = reinterpret_cast<const std::int16_t *>(bytes + ft_weights_at);
+    hidden_bias = reinterpret_cast<const std::int32_t *>(bytes + hidden_bias_at);
+    hidden_weights = reinterpret_cast<const std::int8_t *>(bytes + hidden_weights_at);
+    std::memcpy(&output_bias, bytes + output_bias_at, sizeof(output_bias));
+    output_weights = reinterpret_cast<const std::int8_t *>(bytes + output_weights_at);
+    return true;
+}
+
+// ---- Features ----
+
+// Back rank or not, queen side or king side.
+int kingBucket(Color side, int king_sq)
+{
+    int rel = side == WHITE ? king_sq : king_sq ^ 56;
+    return (rel / 8 == 0 ? 0 : 2) + (rel % 8 < 4 ? 0 : 1);
+}
+
+int featureIndex(Color side, int bucket, Piece p, int sq)
+{
+    int rel_sq = side == WHITE ? sq : sq ^ 56;
+    Color owner = p <= WK ? WHITE : BLACK;
+    int type = (p - WP) % 6;
+    int rel_piece = owner == side ? type : type + 6;
+    return (bucket * 12 + rel_piece) * 64 + rel_sq;
+}
+
+void refresh(const Network &net, const Position &pos, Color side, Accumulator &acc)
+{
+    int bucket = kingBucket(side, kingSquare(side, pos));
+    RowChanges rows;
+    const std::int16_t *from = net.ft_bias;
+    Bitboard pieces = pos.total_pieces;
+    while (pieces)
+    {
+        int sq = pop_lsb(pieces);
+        rows.add[rows.add_count++] = featureRow(net, featureIndex(side, bucket, pos.board[sq], sq));
+        // More pieces than a legal position can have: sum in batches.
+        if (rows.add_count == RowChanges::MAX_ADD && pieces)
+        {
+            applyRows(from, acc.values[side], rows);
+            from = acc.values[side];
+            rows.add_count = 0;
+        }
+    }
+    applyRows(from, acc.values[side], rows);
+    acc.bucket[side] = static_cast<std::int8_t>(bucket);
+    acc.computed[side] = true;
+}
+
+// ---- Dense layers ----
+
+bool available(Simd simd)
+{
+    switch (simd)
+    {
+    case Simd::Scalar:
+        return true;
+#ifdef CHESS_USE_SIMD
+    case Simd::Sse41:
+        return cpuFeatures().sse41;
+    case Simd::Avx2:
+        return cpuFeatures().avx2;
+#endif
+    default:
+        return false;
+    }
+}
+
+Simd bestSimd()
+{
+    static const Simd best = available(Simd::Avx2) ? Simd::Avx2 : available(Simd::Sse41) ? Simd::Sse41 : Simd::Scalar;
+    return best;
+}
+
+int forward(const Network &net, const Accumulator &acc, Color stm, Simd simd)
+{
+    assert(acc.computed[WHITE] && acc.computed[BLACK]);
+    const std::int16_t *us = acc.values[stm];
+    const std::int16_t *them = acc.values[stm == WHITE ? BLACK : WHITE];
+    std::int32_t sums[HIDDEN_SIZE];
+    switch (simd)
+    {
+#ifdef CHESS_USE_SIMD
+    case Simd::Avx2:
+        hiddenAvx2(net, us, them, sums);
+        break;
+    case Simd::Sse41:
+        hiddenSse41(net, us, them, sums);
+        break;
+#endif
+    default:
+        hiddenScalar(net, us, them, sums);
+        break;
+    }
+    return finish(net, sums);
+}
+
+// ---- AccumulatorStack ----
+
+AccumulatorStack::AccumulatorStack(const Network &n, int plies) : net(n), entries(plies)
+{
+}
+
+void AccumulatorStack::reset(const Position &pos)
+{
+    refresh(net, pos, WHITE, entries[0]);
+    refresh(net, pos, BLACK, entries[0]);
+}
+
+void AccumulatorStack::push(int ply, const Position &pos)
+{
+    Accumulator &acc = entries[ply];
+    acc.dirty = pos.dirty;
+    acc.computed[WHITE] = acc.computed[BLACK] = false;
+    acc.bucket[WHITE] = static_cast<std::int8_t>(kingBucket(WHITE, kingSquare(WHITE, pos)));
+    acc.bucket[BLACK] = static_cast<std::int8_t>(kingBucket(BLACK, kingSquare(BLACK, pos)));
+}
+
+// Walks down to the nearest ply with side's half computed, then replays the
+// changes up to ply. A king bucket change, or a change list that overflowed,
+// on the way means the rows to subtract are not the ones that were added,
+// so that case starts over from the board.
+void AccumulatorStack::update(int ply, const Position &pos, Color side)
+{
+    int from = ply;
+    while (!entries[from].computed[side])
+    {
+        const Accumulator &acc = entries[from];
+        if (from == 0 || acc.dirty.count > DirtyPieces::MAX || acc.bucket[side] != entries[from - 1].bucket[side])
+        {
+            refresh(net, pos, side, entries[ply]);
+            return;
+        }
+        from--;
+    }
+    for (int i = from + 1; i <= ply; i++)
+    {
+        Accumulator &acc = entries[i];
+        RowChanges rows;
+        for (int c = 0; c < acc.dirty.count; c++)
+        {
+            const DirtyPieces::Change &change = acc.dirty.changes[c];
+            const std::int16_t *row = featureRow(net, featureIndex(side, acc.bucket[side], change.piece, change.sq));
+            if (change.added)
+                rows.add[rows.add_count++] = row;
+            else
+                rows.sub[rows.sub_count++] = row;
+        }
+        applyRows(entries[i - 1].values[side], acc.values[side], rows);
+        acc.computed[side] = true;
+    }
+}
+
+int AccumulatorStack::evaluate(int ply, const Position &pos)
+{
+    Accumulator &acc = entries[ply];
+    for (Color side : {WHITE, BLACK})
+        if (!acc.computed[side])
+            update(ply, pos, side);
+#ifdef CHESS_VERIFY_INCREMENTAL
+    Accumulator fresh;
+    refresh(net, pos, WHITE, fresh);
+    refresh(net, pos, BLACK, fresh);
+    assert(std::memcmp(fresh.values, acc.values, sizeof(fresh.values)) == 0 &&
+           "AccumulatorStack::evaluate: incremental accumulator drifted");
+#endif
+    return forward(net, acc, pos.side_to_move);
+}
+
+int evaluate(const Network &net, const Position &pos)
+{
+    Accumulator acc;
+    refresh(net, pos, WHITE, acc);
+    refresh(net, pos, BLACK, acc);
+    return forward(net, acc, pos.side_to_move);
+}
+
+} // namespace Nnue
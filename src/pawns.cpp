@@ -0,0 +1,195 @@
+#include "chess/pawns.hpp"
+#include "chess/bitboard.hpp"
+#include "chess/attacks.hpp"
+#include <algorithm>
+#include <array>
+
+namespace
+{
+constexpr int DOUBLED_MG = -10, DOUBLED_EG = -20;  // per extra pawn on a file
+constexpr int ISOLATED_MG = -12, ISOLATED_EG = -8;
+constexpr int BACKWARD_MG = -8, BACKWARD_EG = -6;
+// By rank counted from the pawn's own side (0 = first rank).
+constexpr int PASSED_MG[8] = {0, 0, 5, 10, 20, 35, 55, 0};
+constexpr int PASSED_EG[8] = {0, 5, 10, 20, 35, 60, 90, 0};
+constexpr int SHELTER_NEAR = 12; // own pawn right in front of the king's files
+constexpr int SHELTER_FAR = 6;   // one rank further up
+
+Bitboard fileMask(int file)
+{
+    return FILE_A << file;
+}
+
+Bitboard adjacentFiles(int file)
+{
+    return (file > 0 ? fileMask(file - 1) : 0) | (file < 7 ? fileMask(file + 1) : 0);
+}
+
+// Squares strictly ahead of sq (for side) on its own and the adjacent files:
+// an enemy pawn there stops a passer.
+std::array<std::array<Bitboard, 64>, 2> generatePassedSpan()
+{
+    std::array<std::array<Bitboard, 64>, 2> table{};
+    for (int sq = 0; sq < 64; sq++)
+    {
+        int rank = sq / 8, file = sq % 8;
+        Bitboard files = fileMask(file) | adjacentFiles(file);
+        Bitboard ahead_white = rank < 7 ? ~0ULL << (8 * (rank + 1)) : 0;
+        Bitboard ahead_black = rank > 0 ? ~0ULL >> (8 * (8 - rank)) : 0;
+        table[WHITE][sq] = files & ahead_white;
+        table[BLACK][sq] = files & ahead_black;
+    }
+    return table;
+}
+
+// Squares on the adjacent files level with or behind sq (for side): own
+// pawns there can still come up to support it.
+std::array<std::array<Bitboard, 64>, 2> generateSupportSpan()
+{
+    std::array<std::array<Bitboard, 64>, 2> table{};
+    for (int sq = 0; sq < 64; sq++)
+    {
+        int rank = sq / 8, file = sq % 8;
+        Bitboard up_to_white = ~0ULL >> (8 * (7 - rank));
+        Bitboard up_to_black = ~0ULL << (8 * rank);
+        table[WHITE][sq] = adjacentFiles(file) & up_to_white;
+        table[BLACK][sq] = adjacentFiles(file) & up_to_black;
+    }
+    return table;
+}
+
+const std::array<std::array<Bitboard, 64>, 2> PASSED_SPAN = generatePassedSpan();
+const std::array<std::array<Bitboard, 64>, 2> SUPPORT_SPAN = generateSupportSpan();
+
+// One side's structure terms, from that side's point of view.
+void sidePawns(Color us, Bitboard ours, Bitboard theirs, Bitboard &passed, int &mg, int &eg)
+{
+    passed = 0;
+    mg = eg = 0;
+
+    for (int file = 0; file < 8; file++)
+    {
+        int count = bits_set_count(ours & fileMask(file));
+        if (count > 1)
+        {
+            mg += DOUBLED_MG * (count - 1);
+            eg += DOUBLED_EG * (count - 1);
+        }
+    }
+
+    Bitboard pawns = ours;
+    while (pawns)
+    {
+        int sq = pop_lsb(pawns);
+        int file = sq % 8;
+        int rank = us == WHITE ? sq / 8 : 7 - sq / 8;
+
+        if ((theirs & PASSED_SPAN[us][sq]) == 0)
+        {
+            passed |= convert_to_bit(sq);
+            mg += PASSED_MG[rank];
+            eg += PASSED_EG[rank];
+        }
+
+        if ((ours & adjacentFiles(file)) == 0)
+        {
+            mg += ISOLATED_MG;
+            eg += ISOLATED_EG;
+        }
+        else if ((ours & SUPPORT_SPAN[us][sq]) == 0)
+        {
+            // Nothing can come up beside it, and an enemy pawn guards the
+            // square it would advance to.
+            int stop = us == WHITE ? sq + 8 : sq - 8;
+            if (stop >= 0 && stop < 64 && (PAWN_CAPTURE_TABLE[us][stop] & theirs))
+            {
+                mg += BACKWARD_MG;
+                eg += BACKWARD_EG;
+            }
+        }
+    }
+}
+} // namespace
+
+void evaluatePawns(const Position &pos, PawnEntry &e)
+{
+    int white_mg, white_eg, black_mg, black_eg;
+    sidePawns(WHITE, pos.P, pos.p, e.passed[WHITE], white_mg, white_eg);
+    sidePawns(BLACK, pos.p, pos.P, e.passed[BLACK], black_mg, black_eg);
+    e.check = PawnEntry::checkOf(pos.pawn_key);
+    e.mg = static_cast<std::int16_t>(white_mg - black_mg);
+    e.eg = static_cast<std::int16_t>(white_eg - black_eg);
+    e.shelter_king[WHITE] = e.shelter_king[BLACK] = -1;
+}
+
+int kingShelter(const Position &pos, Color side)
+{
+    int king = kingSquare(side, pos);
+    int file = king % 8;
+    Bitboard files = fileMask(file) | adjacentFiles(file);
+    Bitboard ours = side == WHITE ? pos.P : pos.p;
+    int near_rank = side == WHITE ? king / 8 + 1 : king / 8 - 1;
+    int far_rank = side == WHITE ? king / 8 + 2 : king / 8 - 2;
+    int bonus = 0;
+    if (near_rank >= 0 && near_rank < 8)
+        bonus += SHELTER_NEAR * bits_set_count(ours & files & (RANK_1 << (8 * near_rank)));
+    if (far_rank >= 0 && far_rank < 8)
+        bonus += SHELTER_FAR * bits_set_count(ours & files & (RANK_1 << (8 * far_rank)));
+    return bonus;
+}
+
+PawnTable::PawnTable(std::size_t kb)
+{
+    std::size_t count = 2; // one pair at least
+    while (count * 2 * sizeof(PawnEntry) <= kb * 1024)
+        count *= 2;
+    entries.assign(count, PawnEntry{});
+    mask = count - 1;
+}
+
+void PawnTable::clear()
+{
+    std::fill(entries.begin(), entries.end(), PawnEntry{});
+    probe_count = hit_count = 0;
+}
+
+PawnTable &PawnTables::thread(std::size_t i)
+{
+    while (tables.size() <= i)
+        tables.emplace_back(new PawnTable());
+    return *tables[i];
+}
+
+void PawnTables::clear()
+{
+    for (std::unique_ptr<PawnTable> &t : tables)
+        t->clear();
+}
+
+PawnTables &defaultPawnTables()
+{
+    thread_local PawnTables tables;
+    return tables;
+}
+
+// A cleared entry has check 0 and all-zero terms, which is exactly right
+// for a position without pawns (pawn key 0), so it needs no valid flag.
+PawnEntry &PawnTable::probe(const Position &pos)
+{
+    probe_count++;
+    const std::uint32_t check = PawnEntry::checkOf(pos.pawn_key);
+    PawnEntry *pair = &entries[pos.pawn_key & mask & ~1ULL];
+    if (pair[0].check == check)
+    {
+        hit_count++;
+        return pair[0];
+    }
+    // The second slot holds the older entry: a hit there moves it to the
+    // front, and a miss evicts it.
+    if (pair[1].check != check)
+        evaluatePawns(pos, pair[1]);
+    else
+        hit_count++;
+    std::swap(pair[0], pair[1]);
+    return pair[0];
+}
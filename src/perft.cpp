@@ -0,0 +1,284 @@
+#include "chess/perft.hpp"
+#include "chess/move.hpp"
+#include "chess/movegen.hpp"
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+std::uint64_t perft(Position &pos, StateStack &state, int depth)
+{
+    if (depth == 0)
+        return 1;
+    MoveList moves;
+    generateLegalMoves(pos, moves);
+    if (depth == 1)
+        return moves.size();
+
+    std::uint64_t nodes = 0;
+    for (const Move &m : moves)
+    {
+        makeMove(pos, m, state);
+        nodes += perft(pos, state, depth - 1);
+        UndoMove(pos, state);
+    }
+    return nodes;
+}
+
+std::uint64_t perft(Position &pos, int depth)
+{
+    return perft(pos, defaultStateStack(), depth);
+}
+
+std::uint64_t perftCopy(const Position &pos, int depth)
+{
+    if (depth == 0)
+        return 1;
+    MoveList moves;
+    generateLegalMoves(pos, moves);
+    if (depth == 1)
+        return moves.size();
+
+    std::uint64_t nodes = 0;
+    for (const Move &m : moves)
+        nodes += perftCopy(makeMoveCopy(pos, m), depth - 1);
+    return nodes;
+}
+
+namespace
+{
+// Keys differ per depth so one position can hold counts for several depths.
+constexpr std::uint64_t DEPTH_MIX = 0x9E3779B97F4A7C15ULL;
+
+inline std::uint64_t hashKey(const Position &pos, int depth)
+{
+    return pos.zobrist ^ (DEPTH_MIX * static_cast<std::uint64_t>(depth));
+}
+
+inline std::uint64_t mix64(std::uint64_t h, std::uint64_t v)
+{
+    h ^= v + 0x9E3779B97F4A7C15ULL + (h << 6) + (h >> 2);
+    h *= 0xBF58476D1CE4E5B9ULL;
+    return h ^ (h >> 31);
+}
+
+// Independent of the Zobrist keys: folds the raw board state instead.
+std::uint64_t signature(const Position &pos, int depth)
+{
+    const Bitboard boards[12] = {pos.P, pos.N, pos.B, pos.R, pos.Q, pos.K,
+                                 pos.p, pos.n, pos.b, pos.r, pos.q, pos.k};
+    std::uint64_t h = static_cast<std::uint64_t>(depth);
+    for (Bitboard bb : boards)
+        h = mix64(h, bb);
+    h = mix64(h, static_cast<std::uint64_t>(pos.side_to_move) |
+                     static_cast<std::uint64_t>(pos.castling) << 8 |
+                     static_cast<std::uint64_t>(pos.en_passant + 1) << 16);
+    return h;
+}
+} // namespace
+
+PerftTable::PerftTable(std::size_t mb, bool verify) : verify_(verify)
+{
+    resize(mb);
+}
+
+void PerftTable::resize(std::size_t mb)
+{
+    std::size_t bytes = std::max<std::size_t>(mb, 1) << 20;
+    std::size_t count = 1;
+    while (count * 2 * sizeof(Bucket) <= bytes)
+        count *= 2;
+    buckets_.reset(new Bucket[count]);
+    buckets_count_ = count;
+}
+
+void PerftTable::clear()
+{
+    for (std::size_t i = 0; i < buckets_count_; i++)
+    {
+        for (Entry &e : buckets_[i].slots)
+        {
+            e.lock.store(0, std::memory_order_relaxed);
+            e.data.store(0, std::memory_order_relaxed);
+            e.check.store(0, std::memory_order_relaxed);
+        }
+    }
+}
+
+bool PerftTable::probe(const Position &pos, int depth, std::uint64_t &nodes, PerftHashStats &stats) const
+{
+    stats.probes++;
+    const std::uint64_t key = hashKey(pos, depth);
+    const Bucket &bucket = buckets_[key & (buckets_count_ - 1)];
+    for (const Entry &e : bucket.slots)
+    {
+        std::uint64_t data = e.data.load(std::memory_order_relaxed);
+        std::uint64_t check = e.check.load(std::memory_order_relaxed);
+        if ((e.lock.load(std::memory_order_relaxed) ^ data ^ check) != key ||
+            (data & 0xFF) != static_cast<std::uint64_t>(depth))
+            continue;
+        // Past the lock check the three words come from one write, so a
+        // signature mismatch here is a real key collision.
+        if (verify_ && (check ^ data) != signature(pos, depth))
+        {
+            stats.collisions++;
+            continue;
+        }
+        stats.hits++;
+        nodes = data >> 8;
+        return true;
+    }
+    return false;
+}
+
+void PerftTable::store(const Position &pos, int depth, std::uint64_t nodes, PerftHashStats &stats)
+{
+    stats.stores++;
+    const std::uint64_t key = hashKey(pos, depth);
+    const std::uint64_t data = nodes << 8 | static_cast<std::uint64_t>(depth);
+    Bucket &bucket = buckets_[key & (buckets_count_ - 1)];
+    Entry &deep = bucket.slots[0];
+    Entry &e = static_cast<int>(deep.data.load(std::memory_order_relaxed) & 0xFF) <= depth ? deep : bucket.slots[1];
+    const std::uint64_t check = verify_ ? signature(pos, depth) ^ data : 0;
+    e.data.store(data, std::memory_order_relaxed);
+    e.check.store(check, std::memory_order_relaxed);
+    e.lock.store(key ^ data ^ check, std::memory_order_relaxed);
+}
+
+std::uint64_t perftHashed(Position &pos, StateStack &state, int depth, PerftTable &table, PerftHashStats &stats)
+{
+    if (depth == 0)
+        return 1;
+    std::uint64_t nodes = 0;
+    if (depth >= 2 && table.probe(pos, depth, nodes, stats))
+        return nodes;
+    MoveList moves;
+    generateLegalMoves(pos, moves);
+    if (depth == 1)
+        return moves.size();
+
+    for (const Move &m : moves)
+    {
+        makeMove(pos, m, state);
+        nodes += perftHashed(pos, state, depth - 1, table, stats);
+        UndoMove(pos, state);
+    }
+    table.store(pos, depth, nodes, stats);
+    return nodes;
+}
+
+namespace
+{
+struct PerftTask
+{
+    Position pos;
+    int depth;
+};
+
+struct TaskDeque
+{
+    std::mutex lock;
+    std::deque<std::size_t> tasks;
+};
+
+// Expands the tree one ply at a time with copy-make. Mated or stalemated
+// positions above the split ply simply drop out: they have no leaves.
+std::vector<PerftTask> splitTree(const Position &pos, int depth, int threads, int split_ply, int &ply_out)
+{
+    const std::size_t wanted = static_cast<std::size_t>(threads) * 16;
+    const int max_ply = depth - 1;
+    std::vector<PerftTask> frontier{{pos, depth}};
+    int ply = 0;
+    while (ply < max_ply && (split_ply > 0 ? ply < split_ply : frontier.size() < wanted))
+    {
+        std::vector<PerftTask> next;
+        for (const PerftTask &t : frontier)
+        {
+            MoveList moves;
+            generateLegalMoves(t.pos, moves);
+            for (const Move &m : moves)
+                next.push_back({makeMoveCopy(t.pos, m), t.depth - 1});
+        }
+        frontier.swap(next);
+        ply++;
+    }
+    ply_out = ply;
+    return frontier;
+}
+
+void perftWorker(int id, const std::vector<PerftTask> &tasks, std::vector<TaskDeque> &deques, PerftTable *table,
+                 PerftThreadStats &stats)
+{
+    const int n = static_cast<int>(deques.size());
+    Position pos;
+    StateStack state;
+    for (;;)
+    {
+        std::size_t idx = tasks.size();
+        {
+            std::lock_guard<std::mutex> guard(deques[id].lock);
+            if (!deques[id].tasks.empty())
+            {
+                idx = deques[id].tasks.front();
+                deques[id].tasks.pop_front();
+            }
+        }
+        // Steal from the back so the victim keeps the work it is about to touch.
+        for (int k = 1; k < n && idx == tasks.size(); k++)
+        {
+            TaskDeque &victim = deques[(id + k) % n];
+            std::lock_guard<std::mutex> guard(victim.lock);
+            if (!victim.tasks.empty())
+            {
+                idx = victim.tasks.back();
+                victim.tasks.pop_back();
+                stats.steals++;
+            }
+        }
+        // No task ever gets queued after the workers start, so empty deques
+        // everywhere means the search is finished.
+        if (idx == tasks.size())
+            return;
+
+        auto t0 = std::chrono::steady_clock::now();
+        pos = tasks[idx].pos;
+        state.reset(pos);
+        stats.nodes += table ? perftHashed(pos, state, tasks[idx].depth, *table, stats.hash)
+                             : perft(pos, state, tasks[idx].depth);
+        stats.tasks++;
+        stats.busy_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    }
+}
+} // namespace
+
+ParallelPerftResult perftParallel(const Position &pos, int depth, int threads, int split_ply, PerftTable *table)
+{
+    if (threads <= 0)
+        threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+    ParallelPerftResult result;
+    result.threads.resize(threads);
+    auto t0 = std::chrono::steady_clock::now();
+
+    std::vector<PerftTask> tasks = splitTree(pos, depth, threads, split_ply, result.split_ply);
+    result.tasks = tasks.size();
+
+    std::vector<TaskDeque> deques(threads);
+    for (std::size_t i = 0; i < tasks.size(); i++)
+        deques[i % threads].tasks.push_back(i);
+
+    std::vector<std::thread> pool;
+    pool.reserve(threads - 1);
+    for (int id = 1; id < threads; id++)
+        pool.emplace_back(perftWorker, id, std::cref(tasks), std::ref(deques), table,
+                          std::ref(result.threads[id]));
+    perftWorker(0, tasks, deques, table, result.threads[0]);
+    for (std::thread &t : pool)
+        t.join();
+
+    for (const PerftThreadStats &s : result.threads)
+        result.nodes += s.nodes;
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    return result;
+}
@@ -0,0 +1,401 @@
+// src/perft_main.cpp  (chess_perft: move generator throughput benchmark)
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "chess/position.hpp"
+#include "chess/move.hpp"
+#include "chess/movegen.hpp"
+#include "chess/make_undo.hpp"
+#include "chess/perft.hpp"
+#include "chess/fen.hpp"
+#include "chess/cli.hpp"
+
+struct PerftCase
+{
+    std::string fen;
+    std::vector<std::uint64_t> expected; // expected[d - 1] = perft(d)
+};
+
+struct Options
+{
+    std::string fen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+    std::string epd;
+    int depth = 5;
+    bool depth_set = false;
+    bool suite = false;
+    bool divide = false;
+    bool copy = false;
+    int threads = 1; // 0 = all hardware threads
+    int split = 0;   // split ply for parallel perft, 0 = automatic
+    bool scaling = false;
+    std::size_t hash_mb = 0; // 0 = no perft table
+    bool verify_hash = false;
+};
+
+static const std::vector<PerftCase> &standardSuite()
+{
+    static const std::vector<PerftCase> suite = {
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+         {20, 400, 8902, 197281, 4865609, 119060324}},
+        {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+         {48, 2039, 97862, 4085603, 193690690}},
+        {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+         {14, 191, 2812, 43238, 674624, 11030083}},
+        {"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+         {6, 264, 9467, 422333, 15833292}},
+        {"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+         {44, 1486, 62379, 2103487, 89941194}},
+        {"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+         {46, 2079, 89890, 3894594, 164075551}},
+    };
+    return suite;
+}
+
+// EPD perft lines look like "<fen> ;D1 20 ;D2 400 ;D3 8902".
+static bool parseEpdLine(const std::string &line, PerftCase &out)
+{
+    std::size_t semi = line.find(';');
+    out.fen = line.substr(0, semi);
+    out.expected.clear();
+    if (out.fen.find_first_not_of(" \t\r") == std::string::npos)
+        return false;
+
+    while (semi != std::string::npos)
+    {
+        std::size_t next = line.find(';', semi + 1);
+        std::istringstream field(line.substr(semi + 1, next == std::string::npos ? std::string::npos : next - semi - 1));
+        std::string tag;
+        std::uint64_t count = 0;
+        if (field >> tag >> count && tag.size() > 1 && (tag[0] == 'D' || tag[0] == 'd'))
+        {
+            int d = std::atoi(tag.c_str() + 1);
+            if (d > 0)
+            {
+                if ((int)out.expected.size() < d)
+                    out.expected.resize(d, 0);
+                out.expected[d - 1] = count;
+            }
+        }
+        semi = next;
+    }
+    return true;
+}
+
+static std::uint64_t runPerft(Position &pos, int depth, const Options &opt, PerftTable *table, PerftHashStats &hash)
+{
+    if (opt.threads != 1)
+    {
+        ParallelPerftResult r = perftParallel(pos, depth, opt.threads, opt.split, table);
+        for (const PerftThreadStats &t : r.threads)
+            hash.add(t.hash);
+        return r.nodes;
+    }
+    if (table)
+        return perftHashed(pos, defaultStateStack(), depth, *table, hash);
+    return opt.copy ? perftCopy(pos, depth) : perft(pos, depth);
+}
+
+static void reportHash(const PerftTable *table, const PerftHashStats &hash)
+{
+    if (!table)
+        return;
+    std::cout << "  hash " << (table->sizeBytes() >> 20) << " MB"
+              << "  probes " << hash.probes
+              << "  hits " << hash.hits << " (" << std::fixed << std::setprecision(1)
+              << (hash.probes ? 100.0 * hash.hits / hash.probes : 0.0) << "%)"
+              << std::defaultfloat << "  stores " << hash.stores;
+    if (table->verifying())
+        std::cout << "  collisions caught " << hash.collisions;
+    std::cout << "\n";
+}
+
+static void report(std::uint64_t nodes, double seconds)
+{
+    std::cout << "  nodes " << nodes
+              << "  time " << static_cast<long long>(seconds * 1000.0) << " ms"
+              << "  nps " << static_cast<std::uint64_t>(seconds > 0 ? nodes / seconds : 0) << "\n";
+}
+
+// Per-thread breakdown of one parallel run. Utilisation is busy time over
+// threads * wall time, so it also charges the serial split phase.
+static void reportThreads(const ParallelPerftResult &r)
+{
+    std::cout << " split ply " << r.split_ply << ", " << r.tasks << " subtrees\n";
+    double busy = 0;
+    for (std::size_t i = 0; i < r.threads.size(); i++)
+    {
+        const PerftThreadStats &t = r.threads[i];
+        busy += t.busy_seconds;
+        std::cout << "  thread " << std::setw(3) << i
+                  << "  nodes " << std::setw(12) << t.nodes
+                  << "  (" << std::fixed << std::setprecision(1) << std::setw(5)
+                  << (r.nodes ? 100.0 * t.nodes / r.nodes : 0.0) << "%)"
+                  << "  tasks " << std::setw(5) << t.tasks
+                  << "  steals " << std::setw(5) << t.steals
+                  << "  busy " << std::setw(7) << static_cast<long long>(t.busy_seconds * 1000.0) << " ms\n";
+    }
+    std::cout << "  utilisation " << std::setprecision(1)
+              << (r.seconds > 0 ? 100.0 * busy / (r.seconds * r.threads.size()) : 0.0) << "%\n";
+    std::cout << std::defaultfloat;
+}
+
+// Runs 1, 2, 4, ... up to the requested thread count (plus the count itself)
+// and reports speedup and efficiency against the single-thread run.
+static void scaling(const Position &pos, const Options &opt, PerftTable *table)
+{
+    int max_threads = opt.threads > 0 ? opt.threads : static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    std::vector<int> counts;
+    for (int t = 1; t < max_threads; t *= 2)
+        counts.push_back(t);
+    counts.push_back(max_threads);
+
+    double base = 0;
+    std::cout << " depth " << opt.depth << "\n";
+    for (int t : counts)
+    {
+        // Every run starts from a cold table so the timings stay comparable.
+        if (table)
+            table->clear();
+        ParallelPerftResult r = perftParallel(pos, opt.depth, t, opt.split, table);
+        if (t == 1)
+            base = r.seconds;
+        double speedup = r.seconds > 0 ? base / r.seconds : 0;
+        std::cout << " threads " << std::setw(3) << t;
+        report(r.nodes, r.seconds);
+        std::cout << "  speedup " << std::fixed << std::setprecision(2) << speedup
+                  << "  efficiency " << std::setprecision(1) << 100.0 * speedup / t << "%\n"
+                  << std::defaultfloat;
+    }
+}
+
+static void divide(Position &pos, int depth, bool copy)
+{
+    MoveList root;
+    generateLegalMoves(pos, root);
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::uint64_t total = 0;
+    for (const Move &m : root)
+    {
+        std::uint64_t nodes = 1;
+        if (depth > 1)
+        {
+            if (copy)
+            {
+                nodes = perftCopy(makeMoveCopy(pos, m), depth - 1);
+            }
+            else
+            {
+                makeMove(pos, m);
+                nodes = perft(pos, depth - 1);
+                UndoMove(pos);
+            }
+        }
+        total += nodes;
+        std::cout << move_to_uci(m) << ": " << nodes << "\n";
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    std::cout << "\nMoves: " << root.size() << "\n";
+    report(total, seconds);
+}
+
+// Runs each case from depth 1 up to --depth (or to its deepest known count if
+// that is shallower and no depth was given) and checks the expected counts.
+// Returns false on any mismatch.
+static bool runCases(const std::vector<PerftCase> &cases, const Options &opt, PerftTable *table)
+{
+    PerftHashStats hash;
+    bool all_ok = true;
+    std::uint64_t total_nodes = 0;
+    double total_seconds = 0;
+    for (const PerftCase &c : cases)
+    {
+        Position pos;
+        if (!loadFEN(pos, c.fen))
+        {
+            std::cout << "bad FEN: " << c.fen << "\n";
+            all_ok = false;
+            continue;
+        }
+        int max_depth = opt.depth;
+        if (!opt.depth_set && !c.expected.empty() && (int)c.expected.size() < max_depth)
+            max_depth = static_cast<int>(c.expected.size());
+        std::cout << c.fen << "\n";
+        for (int d = 1; d <= max_depth; d++)
+        {
+            auto t0 = std::chrono::steady_clock::now();
+            std::uint64_t nodes = runPerft(pos, d, opt, table, hash);
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+            total_nodes += nodes;
+            total_seconds += seconds;
+
+            std::uint64_t want = d <= (int)c.expected.size() ? c.expected[d - 1] : 0;
+            std::cout << " depth " << d;
+            if (want != 0)
+            {
+                bool ok = nodes == want;
+                all_ok = all_ok && ok;
+                std::cout << (ok ? " ok  " : " FAIL (expected " + std::to_string(want) + ")");
+            }
+            report(nodes, seconds);
+        }
+    }
+    std::cout << "\nTotal:";
+    report(total_nodes, total_seconds);
+    reportHash(table, hash);
+    std::cout << (all_ok ? "All counts match.\n" : "MISMATCH.\n");
+    return all_ok;
+}
+
+static void usage()
+{
+    std::cout << "usage: chess_perft [options]\n"
+              << "  --fen \"<FEN>\"   position to search (default: start position)\n"
+              << "  --depth N       perft depth (default 5)\n"
+              << "  --divide        print the node count below every root move (single thread, no --hash)\n"
+              << "  --epd FILE      check every line of an EPD file (\";D1 20 ;D2 400 ...\")\n"
+              << "  --suite         check the built-in standard perft suite\n"
+              << "  --copy          use copy-make instead of make/undo (single thread, no --hash or --scaling)\n"
+              << "  --threads N     parallel perft on N threads (0 = all cores)\n"
+              << "  --split N       parallel split ply (default: automatic)\n"
+              << "  --scaling       time 1, 2, 4, ... threads up to --threads\n"
+              << "  --hash MB       cache subtree counts in a shared table of MB megabytes\n"
+              << "  --verify-hash   also check a second signature on every hash hit\n";
+}
+
+int main(int argc, char **argv)
+{
+    Options opt;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--fen" && i + 1 < argc)
+            opt.fen = argv[++i];
+        else if (arg == "--depth" && i + 1 < argc)
+        {
+            opt.depth = std::atoi(argv[++i]);
+            opt.depth_set = true;
+        }
+        else if (arg == "--epd" && i + 1 < argc)
+            opt.epd = argv[++i];
+        else if (arg == "--suite")
+            opt.suite = true;
+        else if (arg == "--divide")
+            opt.divide = true;
+        else if (arg == "--copy")
+            opt.copy = true;
+        else if (arg == "--threads" && i + 1 < argc)
+            opt.threads = std::atoi(argv[++i]);
+        else if (arg == "--split" && i + 1 < argc)
+            opt.split = std::atoi(argv[++i]);
+        else if (arg == "--scaling")
+            opt.scaling = true;
+        else if (arg == "--hash" && i + 1 < argc)
+            opt.hash_mb = static_cast<std::size_t>(std::atoll(argv[++i]));
+        else if (arg == "--verify-hash")
+            opt.verify_hash = true;
+        else
+        {
+            usage();
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+    }
+    if (opt.depth < 1)
+    {
+        std::cout << "depth must be at least 1\n";
+        return 1;
+    }
+    if (opt.threads < 0)
+    {
+        std::cout << "thread count must not be negative\n";
+        return 1;
+    }
+    // Parallel and hashed perft always use make/undo, and divide runs on one
+    // thread without a table: refuse rather than time the wrong thing.
+    if (opt.copy && (opt.threads != 1 || opt.hash_mb > 0 || opt.scaling))
+    {
+        std::cout << "--copy cannot be combined with --threads, --hash or --scaling\n";
+        return 1;
+    }
+    if (opt.divide && (opt.threads != 1 || opt.hash_mb > 0 || opt.scaling))
+    {
+        std::cout << "--divide cannot be combined with --threads, --hash or --scaling\n";
+        return 1;
+    }
+
+    std::unique_ptr<PerftTable> table;
+    if (opt.hash_mb > 0)
+        table.reset(new PerftTable(opt.hash_mb, opt.verify_hash));
+
+    if (opt.suite || !opt.epd.empty())
+    {
+        std::vector<PerftCase> cases;
+        if (opt.suite)
+            cases = standardSuite();
+        if (!opt.epd.empty())
+        {
+            std::ifstream in(opt.epd);
+            if (!in)
+            {
+                std::cout << "cannot open " << opt.epd << "\n";
+                return 1;
+            }
+            std::string line;
+            PerftCase c;
+            while (std::getline(in, line))
+            {
+                if (parseEpdLine(line, c))
+                    cases.push_back(c);
+            }
+        }
+        return runCases(cases, opt, table.get()) ? 0 : 1;
+    }
+
+    Position pos;
+    if (!loadFEN(pos, opt.fen))
+    {
+        std::cout << "bad FEN: " << opt.fen << "\n";
+        return 1;
+    }
+    std::cout << opt.fen << "\n";
+    if (opt.divide)
+    {
+        divide(pos, opt.depth, opt.copy);
+        return 0;
+    }
+    if (opt.scaling)
+    {
+        scaling(pos, opt, table.get());
+        return 0;
+    }
+    if (opt.threads != 1)
+    {
+        ParallelPerftResult r = perftParallel(pos, opt.depth, opt.threads, opt.split, table.get());
+        std::cout << " depth " << opt.depth;
+        report(r.nodes, r.seconds);
+        reportThreads(r);
+        PerftHashStats hash;
+        for (const PerftThreadStats &t : r.threads)
+            hash.add(t.hash);
+        reportHash(table.get(), hash);
+        return 0;
+    }
+    PerftHashStats hash;
+    auto t0 = std::chrono::steady_clock::now();
+    std::uint64_t nodes = runPerft(pos, opt.depth, opt, table.get(), hash);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    std::cout << " depth " << opt.depth;
+    report(nodes, seconds);
+    reportHash(table.get(), hash);
+    return 0;
+}
@@ -5,126 +5,60 @@
 
 Piece getPiece(const Position &pos, int sq)
 {
-    Bitboard board = convert_to_bit(sq);
-    if (pos.P & board)
-        return WP;
-    if (pos.N & board)
-        return WN;
-    if (pos.B & board)
-        return WB;
-    if (pos.R & board)
-        return WR;
-    if (pos.Q & board)
-        return WQ;
-    if (pos.K & board)
-        return WK;
-
-    if (pos.p & board)
-        return BP;
-    if (pos.n & board)
-        return BN;
-    if (pos.b & board)
-        return BB;
-    if (pos.r & board)
-        return BR;
-    if (pos.q & board)
-        return BQ;
-    if (pos.k & board)
-        return BK;
+    return pos.board[sq];
+}
 
-    return EMPTY;
+static Bitboard &pieceBitboard(Position &pos, Piece p)
+{
+    switch (p)
+    {
+    case WP:
+        return pos.P;
+    case WN:
+        return pos.N;
+    case WB:
+        return pos.B;
+    case WR:
+        return pos.R;
+    case WQ:
+        return pos.Q;
+    case WK:
+        return pos.K;
+    case BP:
+        return pos.p;
+    case BN:
+        return pos.n;
+    case BB:
+        return pos.b;
+    case BR:
+        return pos.r;
+    case BQ:
+        return pos.q;
+    default:
+        assert(p == BK && "pieceBitboard: unknown piece id");
+        return pos.k;
+    }
 }
 
 Piece removePiece(Position &pos, int sq)
 {
+    Piece p = pos.board[sq];
+    if (p == EMPTY)
+        return EMPTY;
+
     Bitboard board = convert_to_bit(sq);
-    if (pos.P & board)
-    {
-        pos.P &= ~board;
-        pos.white_pieces &= ~board;
-        pos.total_pieces = pos.white_pieces | pos.black_pieces;
-        return WP;
-    }
-    if (pos.N & board)
-    {
-        pos.N &= ~board;
-        pos.white_pieces &= ~board;
-        pos.total_pieces = pos.white_pieces | pos.black_pieces;
-        return WN;
-    }
-    if (pos.B & board)
-    {
-        pos.B &= ~board;
+    pieceBitboard(pos, p) &= ~board;
+    if (p <= WK)
         pos.white_pieces &= ~board;
-        pos.total_pieces = pos.white_pieces | pos.black_pieces;
-        return WB;
-    }
-    if (pos.R & board)
-    {
-        pos.R &= ~board;
-        pos.white_pieces &= ~board;
-        pos.total_pieces = pos.white_pieces | pos.black_pieces;
-        return WR;
-    }
-    if (pos.Q & board)
-    {
-        pos.Q &= ~board;
-        pos.white_pieces &= ~board;
-        pos.total_pieces = pos.white_pieces | pos.black_pieces;
-        return WQ;
-    }
-    if (pos.K & board)
-    {
-        pos.K &= ~board;
-        pos.white_pieces &= ~board;
-        pos.total_pieces = pos.white_pieces | pos.black_pieces;
-        return WK;
-    }
-
-    if (pos.p & board)
-    {
-        pos.p &= ~board;
-        pos.black_pieces &= ~board;
-        pos.total_pieces = pos.white_pieces | pos.black_pieces;
-        return BP;
-    }
-    if (pos.n & board)
-    {
-        pos.n &= ~board;
-        pos.black_pieces &= ~board;
-        pos.total_pieces = pos.white_pieces | pos.black_pieces;
-        return BN;
-    }
-    if (pos.b & board)
-    {
-        pos.b &= ~board;
-        pos.black_pieces &= ~board;
-        pos.total_pieces = pos.white_pieces | pos.black_pieces;
-        return BB;
-    }
-    if (pos.r & board)
-    {
-        pos.r &= ~board;
-        pos.black_pieces &= ~board;
-        pos.total_pieces = pos.white_pieces | pos.black_pieces;
-        return BR;
-    }
-    if (pos.q & board)
-    {
-        pos.q &= ~board;
-        pos.black_pieces &= ~board;
-        pos.total_pieces = pos.white_pieces | pos.black_pieces;
-        return BQ;
-    }
-    if (pos.k & board)
-    {
-        pos.k &= ~board;
+    else
         pos.black_pieces &= ~board;
-        pos.total_pieces = pos.white_pieces | pos.black_pieces;
-        return BK;
-    }
-
-    return EMPTY;
+    pos.total_pieces = pos.white_pieces | pos.black_pieces;
+    pos.board[sq] = EMPTY;
+    pos.psq_mg -= Psqt::TABLES.mg[p][sq];
+    pos.psq_eg -= Psqt::TABLES.eg[p][sq];
+    pos.phase -= Psqt::PHASE[p];
+    pos.dirty.record(p, sq, false);
+    return p;
 }
 
 void addPiece(Position &pos, int sq, Piece p)
@@ -190,6 +124,46 @@ void addPiece(Position &pos, int sq, Piece p)
         break;
     }
     pos.total_pieces = pos.white_pieces | pos.black_pieces;
+    pos.board[sq] = p;
+    pos.psq_mg += Psqt::TABLES.mg[p][sq];
+    pos.psq_eg += Psqt::TABLES.eg[p][sq];
+    pos.phase += Psqt::PHASE[p];
+    pos.dirty.record(p, sq, true);
+}
+
+bool positionConsistent(const Position &pos)
+{
+    const Bitboard boards[12] = {pos.P, pos.N, pos.B, pos.R, pos.Q, pos.K,
+                                 pos.p, pos.n, pos.b, pos.r, pos.q, pos.k};
+    Bitboard white = 0, black = 0;
+    for (int i = 0; i < 12; i++)
+    {
+        for (int j = i + 1; j < 12; j++)
+        {
+            if (boards[i] & boards[j])
+                return false;
+        }
+        if (i < 6)
+            white |= boards[i];
+        else
+            black |= boards[i];
+    }
+    if (white != pos.white_pieces || black != pos.black_pieces ||
+        (white | black) != pos.total_pieces)
+        return false;
+
+    for (int sq = 0; sq < 64; sq++)
+    {
+        Piece expected = EMPTY;
+        for (int i = 0; i < 12; i++)
+        {
+            if (is_Piece(boards[i], sq))
+                expected = static_cast<Piece>(WP + i);
+        }
+        if (pos.board[sq] != expected)
+            return false;
+    }
+    return true;
 }
 
 void print_pos_board(const Position &pos)
@@ -1,36 +1,45 @@
 #include "chess/repetition.hpp"
 #include "chess/position.hpp"
-
-std::vector<std::uint64_t> g_rep_stack;
+#include "chess/make_undo.hpp"
+#include <algorithm>
 
 void rep_init(const Position& pos) {
-    g_rep_stack.clear();
-    g_rep_stack.push_back(pos.zobrist);
+    defaultStateStack().reset(pos);
 }
 
 void rep_push(const Position& pos) {
-    g_rep_stack.push_back(pos.zobrist);
+    defaultStateStack().keys.push_back(pos.zobrist);
 }
 
 void rep_pop() {
-    if (!g_rep_stack.empty()) g_rep_stack.pop_back();
+    std::vector<std::uint64_t>& keys = defaultStateStack().keys;
+    if (!keys.empty()) keys.pop_back();
 }
 
-int rep_count_current(const Position& pos, int max_plies_window) {
-    if (g_rep_stack.empty()) return 0;
+int rep_count_current(const Position& pos, int max_plies_window, const StateStack& state) {
+    const std::vector<std::uint64_t>& keys = state.keys;
+    if (keys.empty()) return 0;
     const std::uint64_t key = pos.zobrist;
 
     int count = 0;
-    int start = static_cast<int>(g_rep_stack.size()) - 1;       
+    int start = static_cast<int>(keys.size()) - 1;       
     int stop  = std::max(0, start - max_plies_window);          
 
     for (int i = start; i >= stop; --i) {
-        if (g_rep_stack[i] == key) ++count;
+        if (keys[i] == key) ++count;
     }
     return count;
 }
 
-bool is_threefold(const Position& pos) {
+int rep_count_current(const Position& pos, int max_plies_window) {
+    return rep_count_current(pos, max_plies_window, defaultStateStack());
+}
+
+bool is_threefold(const Position& pos, const StateStack& state) {
     const int window = std::max(0, pos.halfmove);
-    return rep_count_current(pos, window) >= 3;
+    return rep_count_current(pos, window, state) >= 3;
+}
+
+bool is_threefold(const Position& pos) {
+    return is_threefold(pos, defaultStateStack());
 }
@@ -0,0 +1,641 @@
+#include "chess/search.hpp"
+#include "chess/movegen.hpp"
+#include "chess/attacks.hpp"
+#include "chess/status.hpp"
+#include "chess/repetition.hpp"
+#include "chess/eval.hpp"
+#include "chess/movepick.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+
+namespace
+{
+// How many nodes pass between clock reads and flushes of the local node
+// count into the shared total.
+constexpr std::uint64_t TIME_CHECK_INTERVAL = 1024;
+
+// Quiescence skips a capture that could not lift the score back to alpha
+// even if it won the victim outright with this much to spare.
+constexpr int DELTA_MARGIN = 200;
+
+// Reverse futility: at depth d a node whose static eval beats beta by
+// RFP_MARGIN * d is assumed to fail high.
+constexpr int RFP_MAX_DEPTH = 6;
+constexpr int RFP_MARGIN = 80;
+
+// Futility: at depth d, quiet moves are skipped when the static eval plus
+// FUTILITY_MARGIN * d is still no better than alpha.
+constexpr int FUTILITY_MAX_DEPTH = 3;
+constexpr int FUTILITY_MARGIN = 120;
+
+constexpr int NULL_MIN_DEPTH = 3;
+constexpr int NULL_BASE_REDUCTION = 3;
+
+// Quiet moves from the LMR_MIN_MOVES + 1-th on are searched shallower first.
+constexpr int LMR_MIN_DEPTH = 3;
+constexpr int LMR_MIN_MOVES = 3;
+
+// Half-width of the first root window; doubled on every fail.
+constexpr int ASPIRATION_MIN_DEPTH = 4;
+constexpr int ASPIRATION_WINDOW = 25;
+
+// Late-move reduction by depth and move number, growing with the log of
+// both.
+struct LmrTable
+{
+    int r[64][64];
+
+    LmrTable()
+    {
+        for (int d = 0; d < 64; d++)
+            for (int m = 0; m < 64; m++)
+                r[d][m] = (d == 0 || m == 0) ? 0 : static_cast<int>(0.75 + std::log(d) * std::log(m) / 2.25);
+    }
+};
+
+const LmrTable LMR;
+
+// Everything the threads of one search have in common.
+struct SharedSearch
+{
+    TranspositionTable &tt;
+    const SearchLimits &limits;
+    std::chrono::steady_clock::time_point start;
+    std::atomic<bool> stop{false};
+    std::atomic<std::uint64_t> nodes{0}; // flushed per-thread counts
+
+    SharedSearch(TranspositionTable &t, const SearchLimits &l)
+        : tt(t), limits(l), start(std::chrono::steady_clock::now())
+    {
+    }
+
+    double elapsed() const
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+};
+
+struct SearchContext
+{
+    Position &pos;
+    StateStack &state;
+    SharedSearch &shared;
+    TranspositionTable &tt;
+    const SearchLimits &limits;
+    std::uint64_t nodes = 0;   // every node, quiescence included
+    std::uint64_t qnodes = 0;  // quiescence nodes alone
+    std::uint64_t flushed = 0; // part of nodes already added to shared.nodes
+    std::uint64_t tt_probes = 0;
+    std::uint64_t tt_hits = 0;
+    std::uint64_t beta_cutoffs = 0;
+    std::uint64_t first_move_cutoffs = 0; // cutoffs on the first move searched
+    bool stopped = false;
+    bool main_thread = false;
+
+    // Triangular PV table: pv[ply][ply .. pv_length[ply]) is the best line
+    // found from ply onwards in the current iteration.
+    PackedMove pv[MAX_PLY][MAX_PLY];
+    int pv_length[MAX_PLY] = {};
+
+    // The previous iteration's PV, searched first while we are still on it.
+    PackedMove prev_pv[MAX_PLY];
+    int prev_pv_length = 0;
+    bool follow_pv = false;
+
+    PackedMove killers[MAX_PLY][2] = {};
+    HistoryTable history;
+    PawnTable &pawns;
+    // pawns' counters when this search started, to report its own share.
+    std::uint64_t pawn_probes_before;
+    std::uint64_t pawn_hits_before;
+    // Per-ply NNUE accumulators; only with limits.network.
+    std::unique_ptr<Nnue::AccumulatorStack> nnue;
+
+    SearchContext(Position &p, StateStack &s, SharedSearch &sh, PawnTable &pt)
+        : pos(p), state(s), shared(sh), tt(sh.tt), limits(sh.limits), pawns(pt),
+          pawn_probes_before(pt.probes()), pawn_hits_before(pt.hits())
+    {
+        if (limits.network && limits.network->loaded())
+        {
+            nnue.reset(new Nnue::AccumulatorStack(*limits.network, MAX_PLY + 1));
+            nnue->reset(pos);
+        }
+    }
+
+    // Static evaluation of pos, reached at ply.
+    int evaluate(int ply)
+    {
+        return nnue ? nnue->evaluate(ply, pos) : ::evaluate(pos, pawns);
+    }
+
+    // A move (or null move) has just taken pos to ply.
+    void moved(int ply)
+    {
+        if (nnue)
+            nnue->push(ply, pos);
+    }
+
+    double elapsed() const { return shared.elapsed(); }
+
+    void flushNodes()
+    {
+        shared.nodes.fetch_add(nodes - flushed, std::memory_order_relaxed);
+        flushed = nodes;
+    }
+
+    // Nodes of every thread; exact for this thread, up to one check
+    // interval behind for the others.
+    std::uint64_t totalNodes() const
+    {
+        return shared.nodes.load(std::memory_order_relaxed) + (nodes - flushed);
+    }
+};
+
+// Any thread that runs out of budget raises the shared stop flag, which
+// winds down all the others.
+bool outOfBudget(SearchContext &ctx)
+{
+    SharedSearch &sh = ctx.shared;
+    if (sh.stop.load(std::memory_order_relaxed))
+        ctx.stopped = true;
+    else if (ctx.limits.stop && ctx.limits.stop->load(std::memory_order_relaxed))
+        ctx.stopped = true;
+    else if (ctx.limits.nodes && ctx.totalNodes() >= ctx.limits.nodes)
+        ctx.stopped = true;
+    else if (ctx.nodes - ctx.flushed >= TIME_CHECK_INTERVAL)
+    {
+        ctx.flushNodes();
+        if (ctx.limits.movetime_ms && ctx.elapsed() * 1000.0 >= static_cast<double>(ctx.limits.movetime_ms))
+            ctx.stopped = true;
+        else if (ctx.limits.time && ctx.limits.time->hardLimitReached(ctx.totalNodes()))
+            ctx.stopped = true;
+    }
+    if (ctx.stopped)
+        sh.stop.store(true, std::memory_order_relaxed);
+    return ctx.stopped;
+}
+
+// Draws the search can claim below the root. A single repetition is enough:
+// if it was worth repeating once, it is worth repeating again.
+bool isDraw(const SearchContext &ctx)
+{
+    const Position &pos = ctx.pos;
+    return pos.halfmove >= 100 || insufficientMaterial(pos) || rep_count_current(pos, pos.halfmove, ctx.state) >= 2;
+}
+
+// A quiet move that refutes the node becomes this ply's first killer and
+// gains history; the quiets searched before it lose as much.
+void updateQuietStats(SearchContext &ctx, int ply, int depth, PackedMove move, const PackedMove *tried, int tried_count)
+{
+    PackedMove *killers = ctx.killers[ply];
+    if (killers[0] != move)
+    {
+        killers[1] = killers[0];
+        killers[0] = move;
+    }
+    Color us = ctx.pos.side_to_move;
+    int bonus = depth * depth;
+    ctx.history.update(us, move, bonus);
+    for (int i = 0; i < tried_count; i++)
+        ctx.history.update(us, tried[i], -bonus);
+}
+
+bool isQuiet(const Move &m)
+{
+    return !(m.flags & (CAPTURE | EN_PASSANT | PROMOTION));
+}
+
+// Anything besides pawns and the king: with none of it, zugzwang is too
+// likely for null-move pruning to be sound.
+bool hasPieces(const Position &pos, Color side)
+{
+    return side == WHITE ? (pos.N | pos.B | pos.R | pos.Q) != 0 : (pos.n | pos.b | pos.r | pos.q) != 0;
+}
+
+bool lastMoveWasNull(const SearchContext &ctx)
+{
+    return !ctx.state.moves.empty() && ctx.state.moves.back().move.isNone();
+}
+
+// Captures and queen promotions only, until the position is quiet. The side to
+// move may stand pat on the static eval unless it is in check, in which
+// case every evasion is searched so mates at the horizon are still seen.
+int quiescence(SearchContext &ctx, int ply, int alpha, int beta)
+{
+    ctx.pv_length[ply] = ply;
+    if (outOfBudget(ctx))
+        return 0;
+    ctx.nodes++;
+    ctx.qnodes++;
+
+    Position &pos = ctx.pos;
+    if (isDraw(ctx))
+        return 0;
+    if (ply >= MAX_PLY - 1)
+        return ctx.evaluate(ply);
+
+    bool in_check = isKinginCheck(pos.side_to_move, pos);
+    int stand_pat = -INF_SCORE;
+    if (!in_check)
+    {
+        stand_pat = ctx.evaluate(ply);
+        if (stand_pat >= beta)
+            return stand_pat;
+        alpha = std::max(alpha, stand_pat);
+    }
+
+    // Out of check the picker already drops captures that lose material in
+    // the exchange: they cannot help the side standing pat.
+    MovePicker picker = in_check ? MovePicker(pos, PackedMove{}, nullptr, ctx.history) : MovePicker(pos);
+    int best = in_check ? -INF_SCORE : stand_pat;
+    int searched = 0;
+    Move m;
+    while (picker.next(m))
+    {
+        if (!in_check && !(m.flags & PROMOTION))
+        {
+            int gain = (m.flags & EN_PASSANT) ? PIECE_VALUE[WP] : PIECE_VALUE[pos.board[m.to]];
+            if (stand_pat + gain + DELTA_MARGIN <= alpha)
+                continue;
+        }
+        searched++;
+
+        makeMove(pos, m, ctx.state);
+        ctx.moved(ply + 1);
+        int score = -quiescence(ctx, ply + 1, -beta, -alpha);
+        UndoMove(pos, ctx.state);
+        if (ctx.stopped)
+            return 0;
+
+        if (score > best)
+        {
+            best = score;
+            if (score > alpha)
+            {
+                alpha = score;
+                if (alpha >= beta)
+                    break;
+            }
+        }
+    }
+    if (in_check && searched == 0)
+        return -MATE_SCORE + ply;
+    return best;
+}
+
+int negamax(SearchContext &ctx, int depth, int ply, int alpha, int beta)
+{
+    if (depth <= 0)
+        return quiescence(ctx, ply, alpha, beta);
+
+    ctx.pv_length[ply] = ply;
+    if (outOfBudget(ctx))
+        return 0;
+    ctx.nodes++;
+
+    Position &pos = ctx.pos;
+    if (ply > 0 && isDraw(ctx))
+        return 0;
+    if (ply >= MAX_PLY - 1)
+        return ctx.evaluate(ply);
+
+    TTData tte;
+    ctx.tt_probes++;
+    bool tt_hit = ctx.tt.probe(pos.zobrist, tte);
+    if (tt_hit)
+    {
+        ctx.tt_hits++;
+        // The root always searches, so it always has a best move to report.
+        if (ply > 0 && tte.depth >= depth)
+        {
+            int score = scoreFromTT(tte.score, ply);
+            if (tte.bound == BOUND_EXACT || (tte.bound == BOUND_LOWER && score >= beta) ||
+                (tte.bound == BOUND_UPPER && score <= alpha))
+                return score;
+        }
+    }
+    PackedMove tt_move = tt_hit ? tte.move : PackedMove{};
+
+    bool on_pv = ctx.follow_pv && ply < ctx.prev_pv_length;
+    ctx.follow_pv = false;
+
+    // Static pruning only happens in zero-window nodes; PV nodes are
+    // searched in full.
+    const bool pv_node = beta - alpha > 1;
+    const bool in_check = isKinginCheck(pos.side_to_move, pos);
+    int static_eval = -INF_SCORE;
+    if (!pv_node && !in_check)
+    {
+        static_eval = ctx.evaluate(ply);
+        if (ctx.limits.reverse_futility && depth <= RFP_MAX_DEPTH && !isMateScore(beta) &&
+            static_eval - RFP_MARGIN * depth >= beta)
+            return static_eval;
+
+        // If passing the move still fails high at reduced depth, a real move
+        // would as well. Never twice in a row, and never with only pawns
+        // left, where zugzwang makes passing look better than it is.
+        if (ctx.limits.null_move && depth >= NULL_MIN_DEPTH && static_eval >= beta &&
+            hasPieces(pos, pos.side_to_move) && !lastMoveWasNull(ctx))
+        {
+            int r = NULL_BASE_REDUCTION + depth / 6;
+            makeNullMove(pos, ctx.state);
+            ctx.moved(ply + 1);
+            ctx.tt.prefetch(pos.zobrist);
+            int score = -negamax(ctx, depth - 1 - r, ply + 1, -beta, -beta + 1);
+            undoNullMove(pos, ctx.state);
+            if (ctx.stopped)
+                return 0;
+            // Do not trust a mate found by passing.
+            if (score >= beta)
+                return isMateScore(score) ? beta : score;
+        }
+    }
+    const bool futile = ctx.limits.futility && !pv_node && !in_check && depth <= FUTILITY_MAX_DEPTH &&
+                        static_eval + FUTILITY_MARGIN * depth <= alpha;
+    // Still on the previous iteration's PV: its move goes first, ahead of
+    // the TT move.
+    PackedMove first = on_pv ? ctx.prev_pv[ply] : tt_move;
+    MovePicker picker = ctx.limits.move_ordering ? MovePicker(pos, first, ctx.killers[ply], ctx.history)
+                                                 : MovePicker(pos, MovePicker::Unordered{});
+
+    const int alpha_orig = alpha;
+    int best = -INF_SCORE;
+    PackedMove best_move;
+    PackedMove quiets_tried[MoveList::CAPACITY];
+    int quiet_count = 0;
+    int searched = 0;
+    Move m;
+    while (picker.next(m))
+    {
+        PackedMove packed = packMove(m);
+        const bool quiet = isQuiet(m);
+        // Only the first child of a PV node can continue the previous PV.
+        ctx.follow_pv = on_pv && searched == 0 && packed == first;
+
+        makeMove(pos, m, ctx.state);
+        ctx.moved(ply + 1);
+        const bool gives_check = isKinginCheck(pos.side_to_move, pos);
+        // The first move is always searched, so "nothing searched" still
+        // means mate or stalemate.
+        if (futile && quiet && !gives_check && searched > 0)
+        {
+            UndoMove(pos, ctx.state);
+            continue;
+        }
+        ctx.tt.prefetch(pos.zobrist);
+        searched++;
+
+        int reduction = 0;
+        if (ctx.limits.lmr && depth >= LMR_MIN_DEPTH && searched > LMR_MIN_MOVES && quiet && !in_check &&
+            !gives_check)
+        {
+            reduction = LMR.r[std::min(depth, 63)][std::min(searched, 63)];
+            if (pv_node)
+                reduction--;
+            if (picker.lastStage() == MovePicker::STAGE_KILLERS)
+                reduction--;
+            reduction = std::max(0, std::min(reduction, depth - 2));
+        }
+
+        int score;
+        if (reduction > 0)
+        {
+            // Zero-window probe at reduced depth; only a move that beats
+            // alpha there gets the full search.
+            score = -negamax(ctx, depth - 1 - reduction, ply + 1, -alpha - 1, -alpha);
+            if (score > alpha && !ctx.stopped)
+                score = -negamax(ctx, depth - 1, ply + 1, -beta, -alpha);
+        }
+        else
+        {
+            score = -negamax(ctx, depth - 1, ply + 1, -beta, -alpha);
+        }
+        UndoMove(pos, ctx.state);
+        if (ctx.stopped)
+            return 0;
+
+        if (score > best)
+        {
+            best = score;
+            if (score > alpha)
+            {
+                alpha = score;
+                best_move = packed;
+                ctx.pv[ply][ply] = packed;
+                for (int j = ply + 1; j < ctx.pv_length[ply + 1]; j++)
+                    ctx.pv[ply][j] = ctx.pv[ply + 1][j];
+                ctx.pv_length[ply] = std::max(ctx.pv_length[ply + 1], ply + 1);
+                if (alpha >= beta)
+                {
+                    ctx.beta_cutoffs++;
+                    if (searched == 1)
+                        ctx.first_move_cutoffs++;
+                    if (quiet)
+                        updateQuietStats(ctx, ply, depth, packed, quiets_tried, quiet_count);
+                    break;
+                }
+            }
+        }
+        if (quiet)
+            quiets_tried[quiet_count++] = packed;
+    }
+    if (searched == 0)
+        return in_check ? -MATE_SCORE + ply : 0;
+
+    Bound bound = best >= beta ? BOUND_LOWER : best > alpha_orig ? BOUND_EXACT : BOUND_UPPER;
+    ctx.tt.store(pos.zobrist, best_move, scoreToTT(best, ply), depth, bound);
+    return best;
+}
+
+// Root search in a window around the previous iteration's score, widened
+// on the side that failed, twice as far each time, until the score lands
+// inside. The window ends up full width, so this always terminates.
+int aspirationSearch(SearchContext &ctx, int depth, int prev_score)
+{
+    int delta = ASPIRATION_WINDOW;
+    int alpha = std::max(prev_score - delta, -INF_SCORE);
+    int beta = std::min(prev_score + delta, INF_SCORE);
+    while (true)
+    {
+        ctx.follow_pv = true;
+        int score = negamax(ctx, depth, 0, alpha, beta);
+        if (ctx.stopped || (score > alpha && score < beta))
+            return score;
+        delta *= 2;
+        if (score <= alpha && ctx.main_thread && ctx.limits.time)
+            ctx.limits.time->failLow();
+        if (score <= alpha)
+            alpha = std::max(score - delta, -INF_SCORE);
+        else
+            beta = std::min(score + delta, INF_SCORE);
+    }
+}
+
+std::vector<Move> rootPv(const SearchContext &ctx)
+{
+    std::vector<Move> line;
+    for (int i = 0; i < ctx.pv_length[0]; i++)
+        line.push_back(unpackMove(ctx.pv[0][i]));
+    return line;
+}
+
+// Iterative deepening on one thread. Only the main thread passes a result
+// to fill in; helpers just keep the shared table busy until told to stop.
+void iterate(SearchContext &ctx, int first_depth, SearchResult *result, const SearchCallback *on_iteration)
+{
+    const int max_depth = std::min(ctx.limits.depth, MAX_PLY - 1);
+    int prev_score = 0;
+    for (int depth = first_depth; depth <= max_depth; depth++)
+    {
+        double depth_start = ctx.elapsed();
+        int score;
+        if (ctx.limits.aspiration && depth >= ASPIRATION_MIN_DEPTH && !isMateScore(prev_score))
+        {
+            score = aspirationSearch(ctx, depth, prev_score);
+        }
+        else
+        {
+            ctx.follow_pv = true;
+            score = negamax(ctx, depth, 0, -INF_SCORE, INF_SCORE);
+        }
+
+        if (ctx.stopped)
+        {
+            if (!result)
+                return;
+            result->stopped = true;
+            // Nothing finished yet: a partial first iteration still beats
+            // returning no move at all.
+            if (!result->has_move)
+            {
+                MoveList root_moves;
+                generateLegalAllMoves(ctx.pos, root_moves);
+                result->best_move = ctx.pv_length[0] > 0 ? unpackMove(ctx.pv[0][0]) : root_moves[0];
+                result->has_move = true;
+            }
+            return;
+        }
+
+        for (int i = 0; i < ctx.pv_length[0]; i++)
+            ctx.prev_pv[i] = ctx.pv[0][i];
+        ctx.prev_pv_length = ctx.pv_length[0];
+        prev_score = score;
+        bool mate_found = isMateScore(score) && MATE_SCORE - std::abs(score) <= depth;
+
+        if (result)
+        {
+            SearchIteration it;
+            it.depth = depth;
+            it.score = score;
+            it.nodes = ctx.totalNodes();
+            it.seconds = ctx.elapsed();
+            it.depth_seconds = it.seconds - depth_start;
+            it.pv = rootPv(ctx);
+
+            result->best_move = it.pv[0];
+            result->has_move = true;
+            result->score = score;
+            result->depth = depth;
+            result->pv = it.pv;
+            result->iterations.push_back(it);
+            if (*on_iteration)
+                (*on_iteration)(it);
+            if (ctx.limits.time && ctx.limits.time->iterationDone(ctx.pv[0][0], score, it.nodes))
+                return;
+        }
+
+        // A mate this close cannot be improved on by searching deeper.
+        if (mate_found)
+            return;
+    }
+}
+} // namespace
+
+SearchResult search(Position &pos, StateStack &state, TranspositionTable &tt, PawnTables &pawns,
+                    const SearchLimits &limits, const SearchCallback &on_iteration)
+{
+    SearchResult result;
+    tt.newSearch();
+
+    GameStatus status = assessStatus(pos, state);
+    if (status.phase == Phase::GameOver)
+    {
+        result.score = status.outcome == Outcome::Draw ? 0 : -MATE_SCORE;
+        return result;
+    }
+
+    SharedSearch shared(tt, limits);
+    const int threads = std::max(1, limits.threads);
+    std::unique_ptr<SearchContext> main(new SearchContext(pos, state, shared, pawns.thread(0)));
+    main->main_thread = true;
+
+    // Helpers get copies of the root position and of the game history, so
+    // they see the same repetitions without touching the caller's stack.
+    std::vector<Position> helper_pos(threads - 1, pos);
+    std::vector<StateStack> helper_state(threads - 1);
+    for (StateStack &st : helper_state)
+        st = state; // assignment keeps the reserved capacity
+    std::vector<std::unique_ptr<SearchContext>> helpers;
+    std::vector<std::thread> pool;
+    for (int i = 0; i < threads - 1; i++)
+        helpers.emplace_back(new SearchContext(helper_pos[i], helper_state[i], shared, pawns.thread(i + 1)));
+    for (int i = 0; i < threads - 1; i++)
+    {
+        SearchContext *ctx = helpers[i].get();
+        int first_depth = 1 + ((i + 1) & 1);
+        pool.emplace_back([ctx, first_depth] { iterate(*ctx, first_depth, nullptr, nullptr); });
+    }
+
+    iterate(*main, 1, &result, &on_iteration);
+    // The main thread decides when the search is over.
+    shared.stop.store(true, std::memory_order_relaxed);
+    for (std::thread &t : pool)
+        t.join();
+
+    main->flushNodes();
+    result.thread_nodes.push_back(main->nodes);
+    result.qnodes = main->qnodes;
+    result.tt_probes = main->tt_probes;
+    result.tt_hits = main->tt_hits;
+    result.beta_cutoffs = main->beta_cutoffs;
+    result.pawn_probes = main->pawns.probes() - main->pawn_probes_before;
+    result.pawn_hits = main->pawns.hits() - main->pawn_hits_before;
+    result.first_move_cutoffs = main->first_move_cutoffs;
+    for (const std::unique_ptr<SearchContext> &h : helpers)
+    {
+        h->flushNodes();
+        result.thread_nodes.push_back(h->nodes);
+        result.qnodes += h->qnodes;
+        result.tt_probes += h->tt_probes;
+        result.tt_hits += h->tt_hits;
+        result.beta_cutoffs += h->beta_cutoffs;
+        result.pawn_probes += h->pawns.probes() - h->pawn_probes_before;
+        result.pawn_hits += h->pawns.hits() - h->pawn_hits_before;
+        result.first_move_cutoffs += h->first_move_cutoffs;
+    }
+    result.nodes = shared.nodes.load(std::memory_order_relaxed);
+    result.seconds = shared.elapsed();
+    result.hashfull = tt.hashfull();
+    return result;
+}
+
+SearchResult search(Position &pos, StateStack &state, TranspositionTable &tt, const SearchLimits &limits,
+                    const SearchCallback &on_iteration)
+{
+    return search(pos, state, tt, defaultPawnTables(), limits, on_iteration);
+}
+
+SearchResult search(Position &pos, StateStack &state, const SearchLimits &limits, const SearchCallback &on_iteration)
+{
+    return search(pos, state, defaultTT(), limits, on_iteration);
+}
+
+SearchResult search(Position &pos, const SearchLimits &limits, const SearchCallback &on_iteration)
+{
+    return search(pos, defaultStateStack(), defaultTT(), limits, on_iteration);
+}
@@ -0,0 +1,93 @@
+#include "chess/see.hpp"
+#include "chess/attacks.hpp"
+#include "chess/bitboard.hpp"
+#include "chess/eval.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+namespace
+{
+// Large enough that capturing a king always ends the sequence.
+constexpr int SEE_KING_VALUE = 20000;
+
+// Lifts the least valuable piece of side out of attackers; returns its value,
+// or -1 when side has nothing left.
+int popLeastValuable(const Position &pos, Color side, Bitboard attackers, Bitboard &from)
+{
+    const bool white = side == WHITE;
+    const Bitboard sets[6] = {white ? pos.P : pos.p, white ? pos.N : pos.n, white ? pos.B : pos.b,
+                              white ? pos.R : pos.r, white ? pos.Q : pos.q, white ? pos.K : pos.k};
+    for (int i = 0; i < 6; i++)
+    {
+        if (Bitboard hit = attackers & sets[i])
+        {
+            from = hit & -hit;
+            return i == 5 ? SEE_KING_VALUE : PIECE_VALUE[WP + i];
+        }
+    }
+    return -1;
+}
+} // namespace
+
+int see(const Position &pos, const Move &move)
+{
+    const int from = move.from;
+    const int to = move.to;
+    Piece mover = pos.board[from];
+
+    // Castling never puts anything en prise that SEE could weigh.
+    if ((mover == WK || mover == BK) && std::abs(from - to) == 2)
+        return 0;
+
+    int gain[32];
+    Bitboard occ = pos.total_pieces ^ convert_to_bit(from);
+    int attacker_value = (mover == WK || mover == BK) ? SEE_KING_VALUE : PIECE_VALUE[mover];
+
+    if (move.flags & EN_PASSANT)
+    {
+        gain[0] = PIECE_VALUE[WP];
+        occ ^= convert_to_bit(pos.side_to_move == WHITE ? to - 8 : to + 8);
+    }
+    else
+    {
+        gain[0] = PIECE_VALUE[pos.board[to]];
+    }
+    if (move.flags & PROMOTION)
+    {
+        gain[0] += PIECE_VALUE[WP + move.promo] - PIECE_VALUE[WP];
+        attacker_value = PIECE_VALUE[WP + move.promo];
+    }
+
+    const Bitboard diag = pos.B | pos.b | pos.Q | pos.q;
+    const Bitboard orth = pos.R | pos.r | pos.Q | pos.q;
+    Bitboard attackers = attackersTo(to, occ, pos) & occ;
+    Color side = pos.side_to_move == WHITE ? BLACK : WHITE;
+
+    int d = 0;
+    while (true)
+    {
+        d++;
+        // What the side to move at depth d nets if it captures the piece
+        // that just landed on to. Speculative until we know it has an
+        // attacker; the last entry is never used. (The usual early exit on
+        // max(-gain[d - 1], gain[d]) < 0 keeps only the sign, and we want
+        // the exact value.)
+        gain[d] = attacker_value - gain[d - 1];
+        if (d == 31)
+            break;
+
+        Bitboard lva = 0;
+        int value = popLeastValuable(pos, side, attackers, lva);
+        if (value < 0)
+            break;
+        occ ^= lva;
+        // Lifting a pawn, bishop, rook or queen can uncover a slider behind it.
+        attackers |= (computeBishopMove(to, occ) & diag) | (computeRookMove(to, occ) & orth);
+        attackers &= occ;
+        attacker_value = value;
+        side = side == WHITE ? BLACK : WHITE;
+    }
+    while (--d)
+        gain[d - 1] = -std::max(-gain[d - 1], gain[d]);
+    return gain[0];
+}
@@ -0,0 +1,111 @@
+#include "chess/timeman.hpp"
+#include <algorithm>
+
+namespace
+{
+// Moves the rest of the game is assumed to last when the GUI does not say,
+// and the most we plan for even when it does.
+constexpr int DEFAULT_MOVES_TO_GO = 30;
+constexpr int MAX_MOVES_TO_GO = 50;
+// The hard limit is this many optima, but never more than MAX_SHARE of
+// what is on the clock.
+constexpr double MAX_RATIO = 4.0;
+constexpr double MAX_SHARE = 0.8;
+
+// A score this far below the previous iteration's counts as a fail low.
+constexpr int FAIL_LOW_MARGIN = 30;
+constexpr double FAIL_LOW_SCALE = 1.5;
+// Once the best move has held this many iterations, finish early.
+constexpr int STABLE_ITERATIONS = 3;
+constexpr double STABLE_SCALE = 0.6;
+constexpr double MIN_SCALE = 0.4;
+constexpr double MAX_SCALE = 2.5;
+} // namespace
+
+TimeManager::TimeManager(const TimeControl &tc)
+{
+    start(tc);
+}
+
+void TimeManager::start(const TimeControl &tc)
+{
+    double usable = static_cast<double>(std::max<std::int64_t>(tc.time_ms - tc.overhead_ms, 1));
+    int moves = tc.moves_to_go > 0 ? std::min(tc.moves_to_go, MAX_MOVES_TO_GO) : DEFAULT_MOVES_TO_GO;
+    double optimum = usable / moves + 0.75 * static_cast<double>(tc.inc_ms);
+    double maximum = std::min(optimum * MAX_RATIO, usable * MAX_SHARE);
+    maximum_ms = std::max<std::int64_t>(static_cast<std::int64_t>(maximum), 1);
+    optimum_ms = std::clamp<std::int64_t>(static_cast<std::int64_t>(optimum), 1, maximum_ms);
+
+    started = std::chrono::steady_clock::now();
+    scale_ = 1.0;
+    last_best = PackedMove{};
+    last_score = 0;
+    have_last = false;
+    best_changes = 0;
+    stable_iterations = 0;
+    fail_low = false;
+    last_nodes = last_iter_nodes = 0;
+}
+
+void TimeManager::simulate(double nodes_per_second)
+{
+    simulated_nps = nodes_per_second;
+}
+
+double TimeManager::elapsedMs(std::uint64_t nodes) const
+{
+    if (simulated_nps > 0)
+        return static_cast<double>(nodes) * 1000.0 / simulated_nps;
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - started).count();
+}
+
+bool TimeManager::iterationDone(PackedMove best, int score, std::uint64_t nodes)
+{
+    if (have_last)
+    {
+        if (best != last_best)
+        {
+            best_changes += 1;
+            stable_iterations = 0;
+        }
+        else
+            stable_iterations++;
+        if (score < last_score - FAIL_LOW_MARGIN)
+            fail_low = true;
+    }
+
+    // A fail low outweighs a best move that has held: the move may be
+    // about to change.
+    double scale = 1.0 + best_changes;
+    if (fail_low)
+        scale *= FAIL_LOW_SCALE;
+    else if (stable_iterations >= STABLE_ITERATIONS)
+        scale *= STABLE_SCALE;
+    scale_ = std::clamp(scale, MIN_SCALE, MAX_SCALE);
+
+    // Older changes count for less each iteration; a fail low only for the
+    // iteration it happened in.
+    best_changes *= 0.5;
+    fail_low = false;
+    std::uint64_t iter_nodes = nodes - last_nodes;
+    double growth = last_iter_nodes ? static_cast<double>(iter_nodes) / static_cast<double>(last_iter_nodes) : 3.0;
+    last_best = best;
+    last_score = score;
+    have_last = true;
+    last_nodes = nodes;
+    last_iter_nodes = iter_nodes;
+
+    double elapsed = elapsedMs(nodes);
+    if (elapsed >= static_cast<double>(optimum_ms) * scale_)
+        return true;
+    // The next iteration at the node rate so far, growing by the same
+    // factor as the last one did.
+    if (elapsed > 0 && iter_nodes > 0)
+    {
+        double ms_per_node = elapsed / static_cast<double>(nodes);
+        double next_ms = static_cast<double>(iter_nodes) * std::clamp(growth, 1.5, 6.0) * ms_per_node;
+        if (elapsed + next_ms > static_cast<double>(maximum_ms))
+            return true;
+    }
+    return false;
+}
@@ -0,0 +1,146 @@
+#include "chess/tt.hpp"
+#include "chess/search.hpp"
+#include <algorithm>
+
+namespace
+{
+constexpr int AGE_BITS = 6;
+constexpr std::uint8_t AGE_MASK = (1 << AGE_BITS) - 1;
+
+inline std::uint64_t packData(PackedMove move, int score, int depth, Bound bound, std::uint8_t age)
+{
+    return static_cast<std::uint64_t>(move.data) |
+           static_cast<std::uint64_t>(static_cast<std::uint16_t>(score)) << 16 |
+           static_cast<std::uint64_t>(static_cast<std::uint8_t>(depth)) << 32 |
+           static_cast<std::uint64_t>(bound) << 40 |
+           static_cast<std::uint64_t>(age & AGE_MASK) << 42;
+}
+
+inline PackedMove dataMove(std::uint64_t d) { return PackedMove{static_cast<std::uint16_t>(d)}; }
+inline int dataScore(std::uint64_t d) { return static_cast<std::int16_t>(d >> 16); }
+inline int dataDepth(std::uint64_t d) { return static_cast<std::uint8_t>(d >> 32); }
+inline Bound dataBound(std::uint64_t d) { return static_cast<Bound>((d >> 40) & 3); }
+inline std::uint8_t dataAge(std::uint64_t d) { return static_cast<std::uint8_t>((d >> 42) & AGE_MASK); }
+} // namespace
+
+TranspositionTable::TranspositionTable(std::size_t mb)
+{
+    resize(mb);
+}
+
+void TranspositionTable::resize(std::size_t mb)
+{
+    std::size_t bytes = std::max<std::size_t>(mb, 1) << 20;
+    std::size_t count = 1;
+    while (count * 2 * sizeof(Bucket) <= bytes)
+        count *= 2;
+    buckets_.reset(new Bucket[count]());
+    mask_ = count - 1;
+    age_ = 0;
+}
+
+void TranspositionTable::clear()
+{
+    for (std::uint64_t i = 0; i <= mask_; i++)
+    {
+        for (Entry &e : buckets_[i].entries)
+        {
+            e.key_xor_data.store(0, std::memory_order_relaxed);
+            e.data.store(0, std::memory_order_relaxed);
+        }
+    }
+    age_ = 0;
+}
+
+void TranspositionTable::newSearch()
+{
+    age_ = (age_ + 1) & AGE_MASK;
+}
+
+bool TranspositionTable::probe(std::uint64_t key, TTData &out) const
+{
+    const Bucket &bucket = buckets_[key & mask_];
+    for (const Entry &e : bucket.entries)
+    {
+        std::uint64_t data = e.data.load(std::memory_order_relaxed);
+        if ((e.key_xor_data.load(std::memory_order_relaxed) ^ data) != key || dataBound(data) == BOUND_NONE)
+            continue;
+        out.move = dataMove(data);
+        out.score = dataScore(data);
+        out.depth = dataDepth(data);
+        out.bound = dataBound(data);
+        return true;
+    }
+    return false;
+}
+
+void TranspositionTable::store(std::uint64_t key, PackedMove move, int score, int depth, Bound bound)
+{
+    Bucket &bucket = buckets_[key & mask_];
+
+    // Same position: update in place. Otherwise replace the entry worth the
+    // least, where every generation of age costs as much as 8 plies of depth.
+    Entry *victim = &bucket.entries[0];
+    int victim_worth = 1 << 30;
+    for (Entry &e : bucket.entries)
+    {
+        std::uint64_t data = e.data.load(std::memory_order_relaxed);
+        if ((e.key_xor_data.load(std::memory_order_relaxed) ^ data) == key && dataBound(data) != BOUND_NONE)
+        {
+            if (move.isNone())
+                move = dataMove(data);
+            if (bound != BOUND_EXACT && dataAge(data) == age_ && depth < dataDepth(data) - 2)
+                return;
+            victim = &e;
+            break;
+        }
+        int age_diff = (age_ - dataAge(data)) & AGE_MASK;
+        int worth = dataBound(data) == BOUND_NONE ? -(1 << 30) : dataDepth(data) - 8 * age_diff;
+        if (worth < victim_worth)
+        {
+            victim = &e;
+            victim_worth = worth;
+        }
+    }
+    std::uint64_t data = packData(move, score, std::max(depth, 0), bound, age_);
+    victim->data.store(data, std::memory_order_relaxed);
+    victim->key_xor_data.store(key ^ data, std::memory_order_relaxed);
+}
+
+int TranspositionTable::hashfull() const
+{
+    std::size_t buckets = std::min<std::size_t>(1000, mask_ + 1);
+    std::size_t used = 0;
+    for (std::size_t i = 0; i < buckets; i++)
+        for (const Entry &e : buckets_[i].entries)
+        {
+            std::uint64_t data = e.data.load(std::memory_order_relaxed);
+            if (dataBound(data) != BOUND_NONE && dataAge(data) == age_)
+                used++;
+        }
+    return static_cast<int>(used * 1000 / (buckets * BUCKET_ENTRIES));
+}
+
+TranspositionTable &defaultTT()
+{
+    static TranspositionTable table;
+    return table;
+}
+
+int scoreToTT(int score, int ply)
+{
+    if (score >= MATE_BOUND)
+        return score + ply;
+    if (score <= -MATE_BOUND)
+        return score - ply;
+    return score;
+}
+
+int scoreFromTT(int score, int ply)
+{
+    if (score >= MATE_BOUND)
+        return score - ply;
+    if (score <= -MATE_BOUND)
+        return score + ply;
+    return score;
+}
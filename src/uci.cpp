@@ -0,0 +1,338 @@
+#include "chess/uci.hpp"
+#include "chess/movegen.hpp"
+#include "chess/perft.hpp"
+#include "chess/fen.hpp"
+#include "chess/cli.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+namespace
+{
+const char *START_FEN = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+constexpr std::size_t DEFAULT_HASH_MB = 16;
+constexpr std::size_t MAX_HASH_MB = 65536;
+constexpr int MAX_THREADS = 256;
+constexpr std::int64_t MAX_OVERHEAD_MS = 5000;
+
+std::string scoreString(int score)
+{
+    if (!isMateScore(score))
+        return "cp " + std::to_string(score);
+    int plies = MATE_SCORE - std::abs(score);
+    int moves = (plies + 1) / 2;
+    return "mate " + std::to_string(score > 0 ? moves : -moves);
+}
+
+std::string pvString(const std::vector<Move> &pv)
+{
+    std::string line;
+    for (const Move &m : pv)
+        line += " " + move_to_uci(m);
+    return line;
+}
+
+std::string lowerCase(std::string text)
+{
+    for (char &c : text)
+        c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    return text;
+}
+
+// The legal move in pos written as text in UCI notation, if there is one.
+bool parseMove(Position &pos, const std::string &text, Move &move)
+{
+    MoveList legal;
+    generateLegalMoves(pos, legal);
+    for (const Move &m : legal)
+    {
+        if (move_to_uci(m) == text)
+        {
+            move = m;
+            return true;
+        }
+    }
+    return false;
+}
+} // namespace
+
+UciEngine::UciEngine(std::ostream &o) : out(o), tt(DEFAULT_HASH_MB)
+{
+    loadFEN(pos, START_FEN);
+    state.reset(pos);
+}
+
+UciEngine::~UciEngine()
+{
+    stopSearch();
+}
+
+void UciEngine::send(const std::string &line)
+{
+    std::lock_guard<std::mutex> lock(out_mutex);
+    out << line << std::endl;
+}
+
+void UciEngine::wait()
+{
+    if (worker.joinable())
+        worker.join();
+}
+
+void UciEngine::stopSearch()
+{
+    {
+        std::lock_guard<std::mutex> lock(stop_mutex);
+        stop.store(true);
+    }
+    stop_cv.notify_all();
+    wait();
+}
+
+bool UciEngine::command(const std::string &line)
+{
+    std::istringstream args(line);
+    std::string cmd;
+    if (!(args >> cmd))
+        return true;
+
+    if (cmd == "uci")
+    {
+        send("id name Chess");
+        send("id author the Chess authors");
+        send("option name Hash type spin default " + std::to_string(DEFAULT_HASH_MB) + " min 1 max " +
+             std::to_string(MAX_HASH_MB));
+        send("option name Threads type spin default 1 min 1 max " + std::to_string(MAX_THREADS));
+        send("option name Move Overhead type spin default " + std::to_string(move_overhead_ms) + " min 0 max " +
+             std::to_string(MAX_OVERHEAD_MS));
+        send("option name EvalFile type string default <empty>");
+        send("uciok");
+    }
+    else if (cmd == "isready")
+        send("readyok");
+    else if (cmd == "ucinewgame")
+    {
+        stopSearch();
+        tt.clear();
+    }
+    else if (cmd == "position")
+    {
+        stopSearch();
+        setPosition(args);
+    }
+    else if (cmd == "go")
+    {
+        stopSearch();
+        go(args);
+    }
+    else if (cmd == "stop")
+        stopSearch();
+    else if (cmd == "setoption")
+    {
+        stopSearch();
+        setOption(args);
+    }
+    else if (cmd == "quit")
+    {
+        stopSearch();
+        return false;
+    }
+    else
+        send("info string unknown command " + cmd);
+    return true;
+}
+
+void UciEngine::loop(std::istream &in)
+{
+    std::string line;
+    while (std::getline(in, line))
+    {
+        if (!command(line))
+            return;
+    }
+    if (infinite)
+        stopSearch();
+    wait();
+}
+
+// position startpos|fen <fen> [moves <move>...]
+void UciEngine::setPosition(std::istream &args)
+{
+    std::string token, fen;
+    args >> token;
+    if (token == "startpos")
+    {
+        fen = START_FEN;
+        args >> token;
+    }
+    else if (token == "fen")
+    {
+        while (args >> token && token != "moves")
+            fen += (fen.empty() ? "" : " ") + token;
+    }
+    else
+    {
+        send("info string expected startpos or fen");
+        return;
+    }
+
+    Position next;
+    if (!loadFEN(next, fen))
+    {
+        send("info string bad fen " + fen);
+        return;
+    }
+    pos = next;
+    state.reset(pos);
+    if (token != "moves")
+        return;
+    while (args >> token)
+    {
+        Move m;
+        if (!parseMove(pos, token, m))
+        {
+            send("info string illegal move " + token);
+            return;
+        }
+        makeMove(pos, m, state);
+    }
+}
+
+// go [depth N] [nodes N] [movetime MS] [wtime MS] [btime MS] [winc MS]
+//    [binc MS] [movestogo N] [infinite] | perft N
+void UciEngine::go(std::istream &args)
+{
+    SearchLimits limits;
+    limits.threads = threads;
+    limits.network = network.loaded() ? &network : nullptr;
+    limits.stop = &stop;
+    std::int64_t time[2] = {0, 0}, inc[2] = {0, 0};
+    bool has_time[2] = {false, false};
+    int moves_to_go = 0;
+    infinite = false;
+
+    std::string token;
+    while (args >> token)
+    {
+        if (token == "perft")
+        {
+            int depth = 1;
+            args >> depth;
+            perft(std::max(depth, 1));
+            return;
+        }
+        if (token == "depth")
+            args >> limits.depth;
+        else if (token == "nodes")
+            args >> limits.nodes;
+        else if (token == "movetime")
+            args >> limits.movetime_ms;
+        else if (token == "wtime")
+            has_time[WHITE] = static_cast<bool>(args >> time[WHITE]);
+        else if (token == "btime")
+            has_time[BLACK] = static_cast<bool>(args >> time[BLACK]);
+        else if (token == "winc")
+            args >> inc[WHITE];
+        else if (token == "binc")
+            args >> inc[BLACK];
+        else if (token == "movestogo")
+            args >> moves_to_go;
+        else if (token == "infinite")
+            infinite = true;
+    }
+    limits.depth = std::clamp(limits.depth, 1, MAX_PLY - 1);
+    Color us = pos.side_to_move;
+    // A clock at or below zero still gets a deadline: a lagging GUI sends
+    // those, and the time manager leaves it a millisecond to move in.
+    if (!infinite && !limits.movetime_ms && has_time[us])
+    {
+        TimeControl tc;
+        tc.time_ms = time[us];
+        tc.inc_ms = inc[us];
+        tc.moves_to_go = moves_to_go;
+        tc.overhead_ms = move_overhead_ms;
+        timer.start(tc);
+        limits.time = &timer;
+    }
+
+    search_pos = pos;
+    search_state = state;
+    stop.store(false);
+    worker = std::thread([this, limits] {
+        SearchResult r = search(search_pos, search_state, tt, pawns, limits, [this](const SearchIteration &it) {
+            std::uint64_t nps = it.seconds > 0 ? static_cast<std::uint64_t>(it.nodes / it.seconds) : 0;
+            send("info depth " + std::to_string(it.depth) + " score " + scoreString(it.score) + " nodes " +
+                 std::to_string(it.nodes) + " nps " + std::to_string(nps) + " time " +
+                 std::to_string(static_cast<long long>(it.seconds * 1000.0)) + " pv" + pvString(it.pv));
+        });
+        // UCI: an infinite search reports its move only once told to stop.
+        if (infinite)
+        {
+            std::unique_lock<std::mutex> lock(stop_mutex);
+            stop_cv.wait(lock, [this] { return stop.load(); });
+        }
+        std::string best = r.has_move ? move_to_uci(r.best_move) : "0000";
+        if (r.has_move && r.pv.size() > 1)
+            send("bestmove " + best + " ponder " + move_to_uci(r.pv[1]));
+        else
+            send("bestmove " + best);
+    });
+}
+
+// Per-move counts, as chess_perft --divide prints them.
+void UciEngine::perft(int depth)
+{
+    MoveList legal;
+    generateLegalMoves(pos, legal);
+    std::uint64_t total = 0;
+    for (const Move &m : legal)
+    {
+        makeMove(pos, m, state);
+        std::uint64_t nodes = depth > 1 ? ::perft(pos, state, depth - 1) : 1;
+        UndoMove(pos, state);
+        total += nodes;
+        send(move_to_uci(m) + ": " + std::to_string(nodes));
+    }
+    send("");
+    send("Nodes searched: " + std::to_string(total));
+}
+
+// setoption name <id> [value <x>]
+// Option names are not case sensitive; values (file names) are kept as given.
+void UciEngine::setOption(std::istream &args)
+{
+    std::string token, name, value;
+    args >> token; // "name"
+    while (args >> token && lowerCase(token) != "value")
+        name += (name.empty() ? "" : " ") + token;
+    std::getline(args >> std::ws, value);
+
+    const std::string id = lowerCase(name);
+    if (id == "hash")
+        tt.resize(std::clamp<std::size_t>(std::strtoull(value.c_str(), nullptr, 10), 1, MAX_HASH_MB));
+    else if (id == "threads")
+        threads = std::clamp(std::atoi(value.c_str()), 1, MAX_THREADS);
+    else if (id == "move overhead")
+        move_overhead_ms = std::clamp<std::int64_t>(std::atoll(value.c_str()), 0, MAX_OVERHEAD_MS);
+    else if (id == "evalfile")
+    {
+        // Empty (or "<empty>") goes back to the hand-written evaluation.
+        eval_file = value == "<empty>" ? "" : value;
+        if (eval_file.empty())
+        {
+            network.unload();
+            return;
+        }
+        std::string error;
+        if (network.load(eval_file, &error))
+            send("info string loaded network " + eval_file);
+        else
+            send("info string " + error);
+    }
+    else
+        send("info string unknown option " + name);
+}
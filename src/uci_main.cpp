@@ -0,0 +1,12 @@
+// src/uci_main.cpp  (chess_uci: UCI engine for GUIs and match runners)
+#include <iostream>
+
+#include "chess/uci.hpp"
+
+int main()
+{
+    std::ios::sync_with_stdio(false);
+    UciEngine engine(std::cout);
+    engine.loop(std::cin);
+    return 0;
+}
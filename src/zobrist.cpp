@@ -16,7 +16,7 @@ static inline std::uint64_t splitmix64(std::uint64_t& s) {
     return z ^ (z >> 31);
 }
 
-void init() {
+static void fill_keys() {
     std::uint64_t seed = 0xC0FFEEULL ^ 0xFEEDBEEFULL; 
     for (int p = 0; p < 12; ++p)
         for (int sq = 0; sq < 64; ++sq)
@@ -27,6 +27,13 @@ void init() {
     SIDE = splitmix64(seed);
 }
 
+// Fills the tables on the first call only, so positions can be set up from
+// several threads without rewriting keys another thread is reading.
+void init() {
+    static const bool ready = (fill_keys(), true);
+    (void)ready;
+}
+
 std::uint64_t compute(const Position& pos) {
     std::uint64_t h = 0;
 
@@ -65,4 +72,13 @@ std::uint64_t compute(const Position& pos) {
 
     return h;
 }
+
+std::uint64_t computePawnKey(const Position& pos) {
+    std::uint64_t h = 0;
+    Bitboard x = pos.P;
+    while (x) h ^= PIECE_SQ[piece_index(WP)][pop_lsb(x)];
+    x = pos.p;
+    while (x) h ^= PIECE_SQ[piece_index(BP)][pop_lsb(x)];
+    return h;
+}
 }
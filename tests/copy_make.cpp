@@ -0,0 +1,62 @@
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include "chess/position.hpp"
+#include "chess/move.hpp"
+#include "chess/movegen.hpp"
+#include "chess/make_undo.hpp"
+#include "chess/perft.hpp"
+#include "chess/fen.hpp"
+
+// Every child from makeMoveCopy must match make/undo, and the parent must be
+// left exactly as it was.
+static void compare_children(Position& pos, int depth) {
+    MoveList moves;
+    generateLegalMoves(pos, moves);
+    std::string parent_fen = saveFEN(pos);
+    std::uint64_t parent_key = pos.zobrist;
+    for (const auto& m : moves) {
+        Position child = makeMoveCopy(pos, m);
+        assert(saveFEN(pos) == parent_fen && pos.zobrist == parent_key);
+
+        makeMove(pos, m);
+        assert(saveFEN(child) == saveFEN(pos));
+        assert(child.zobrist == pos.zobrist);
+        assert(positionConsistent(child));
+        if (depth > 1) compare_children(pos, depth - 1);
+        UndoMove(pos);
+    }
+}
+
+int main() {
+    const char* fens[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    };
+    const int depths[] = {5, 4, 4};
+    const uint64_t expected[] = {4865609ULL, 4085603ULL, 422333ULL};
+
+    for (int i = 0; i < 3; ++i) {
+        Position p;
+        bool ok = loadFEN(p, fens[i]);
+        assert(ok);
+        compare_children(p, 2);
+
+        auto t0 = std::chrono::steady_clock::now();
+        uint64_t make_undo = perft(p, depths[i]);
+        auto t1 = std::chrono::steady_clock::now();
+        uint64_t copy = perftCopy(p, depths[i]);
+        auto t2 = std::chrono::steady_clock::now();
+        assert(make_undo == expected[i]);
+        assert(copy == expected[i]);
+
+        double mu_ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+        double cm_ms = std::chrono::duration<double, std::milli>(t2 - t1).count();
+        std::cout << "perft(" << depths[i] << ") " << fens[i] << "\n"
+                  << "  make/undo=" << mu_ms << "ms  copy-make=" << cm_ms << "ms\n";
+    }
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include "chess/position.hpp"
+#include "chess/move.hpp"
+#include "chess/movegen.hpp"
+#include "chess/make_undo.hpp"
+#include "chess/eval.hpp"
+#include "chess/psqt.hpp"
+#include "chess/fen.hpp"
+
+static void check_terms(const Position& pos) {
+    int mg, eg, phase;
+    Psqt::compute(pos, mg, eg, phase);
+    assert(mg == pos.psq_mg && eg == pos.psq_eg && phase == pos.phase);
+    assert(evaluate(pos) == evaluateFromScratch(pos));
+}
+
+// Walks the tree checking the incremental terms after every makeMove and
+// every UndoMove, promotions, castling and en passant included.
+static uint64_t walk(Position& pos, int depth) {
+    check_terms(pos);
+    if (depth == 0) return 1;
+    MoveList moves;
+    generateLegalMoves(pos, moves);
+    uint64_t nodes = 0;
+    for (const Move& m : moves) {
+        int before = evaluate(pos);
+        makeMove(pos, m);
+        nodes += walk(pos, depth - 1);
+        UndoMove(pos);
+        assert(evaluate(pos) == before);
+    }
+    return nodes;
+}
+
+int main() {
+    Position pos;
+    pos.start_position();
+    check_terms(pos);
+    // Symmetric, full phase.
+    assert(evaluate(pos) == 0 && pos.phase == Psqt::MAX_PHASE);
+
+    const char* fens[] = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    };
+    for (const char* fen : fens) {
+        bool ok = loadFEN(pos, fen);
+        assert(ok);
+        (void)ok;
+        walk(pos, 3);
+    }
+
+    // Mirrored positions score the same for the side to move.
+    bool ok = loadFEN(pos, "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3");
+    assert(ok);
+    int white_view = evaluate(pos);
+    ok = loadFEN(pos, "rnbqkb1r/pppp1ppp/5n2/4p3/4P3/2N5/PPPP1PPP/R1BQKBNR b KQkq - 2 3");
+    assert(ok);
+    (void)ok;
+    assert(evaluate(pos) == white_view);
+
+    // Kings and pawns only: pure endgame, and an extra pawn is worth about one.
+    ok = loadFEN(pos, "4k3/8/8/8/8/8/4P3/4K3 w - - 0 1");
+    assert(ok);
+    assert(pos.phase == 0 && evaluate(pos) > 50 && evaluate(pos) < 250);
+
+    std::cout << "eval_incremental passed\n";
+    return 0;
+}
@@ -0,0 +1,82 @@
+#include <cassert>
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <tuple>
+#include <vector>
+#include "chess/position.hpp"
+#include "chess/move.hpp"
+#include "chess/movegen.hpp"
+#include "chess/make_undo.hpp"
+#include "chess/fen.hpp"
+
+static bool move_less(const Move& a, const Move& b) {
+    return std::tie(a.from, a.to, a.flags, a.promo) < std::tie(b.from, b.to, b.flags, b.promo);
+}
+
+static std::vector<Move> sorted(const MoveList& list) {
+    std::vector<Move> v(list.begin(), list.end());
+    std::sort(v.begin(), v.end(), move_less);
+    return v;
+}
+
+// At every node, captures + quiets must be exactly the legal moves, with no
+// overlap, and the capture generator must emit only noisy moves.
+static uint64_t check_split(Position& pos, int depth, uint64_t& noisy) {
+    MoveList all, captures, quiets;
+    generateLegalMoves(pos, all);
+    generateLegalCaptures(pos, captures);
+    generateLegalQuiets(pos, quiets);
+
+    for (const Move& m : captures)
+        assert(m.flags & (CAPTURE | EN_PASSANT | PROMOTION));
+    for (const Move& m : quiets)
+        assert(!(m.flags & (CAPTURE | EN_PASSANT | PROMOTION)));
+    MoveList joined = captures;
+    for (const Move& m : quiets) joined.push_back(m);
+    assert(sorted(joined) == sorted(all));
+    noisy += captures.size();
+
+    if (depth == 1) return all.size();
+    uint64_t nodes = 0;
+    for (const Move& m : all) {
+        makeMove(pos, m);
+        nodes += check_split(pos, depth - 1, noisy);
+        UndoMove(pos);
+    }
+    return nodes;
+}
+
+int main() {
+    struct Case { const char* fen; int depth; uint64_t nodes; };
+    const Case cases[] = {
+        {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 3, 97862ULL},
+        {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 4, 43238ULL},
+        {"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 3, 9467ULL},
+        {"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 3, 62379ULL},
+        // En passant that would expose the king, and a quiet promotion.
+        {"8/8/8/KPp4r/8/8/8/4k3 w - c6 0 1", 3, 0},
+        {"8/P6k/8/8/8/8/8/K7 w - - 0 1", 3, 0},
+    };
+    for (const Case& c : cases) {
+        Position pos;
+        bool ok = loadFEN(pos, c.fen);
+        assert(ok);
+        (void)ok;
+        uint64_t noisy = 0;
+        uint64_t nodes = check_split(pos, c.depth, noisy);
+        if (c.nodes) assert(nodes == c.nodes);
+        assert(noisy > 0);
+        std::cout << c.fen << ": " << nodes << " nodes, " << noisy << " noisy moves\n";
+    }
+
+    // The e.p. capture here would expose the king to the rook on h5.
+    Position pos;
+    loadFEN(pos, "8/8/8/KPp4r/8/8/8/4k3 w - c6 0 1");
+    MoveList captures;
+    generateLegalCaptures(pos, captures);
+    for (const Move& m : captures) assert(!(m.flags & EN_PASSANT));
+
+    std::cout << "legal_captures passed\n";
+    return 0;
+}
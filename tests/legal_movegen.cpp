@@ -0,0 +1,121 @@
+#include <cassert>
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <tuple>
+#include <vector>
+#include "chess/position.hpp"
+#include "chess/move.hpp"
+#include "chess/movegen.hpp"
+#include "chess/make_undo.hpp"
+#include "chess/fen.hpp"
+
+static bool move_less(const Move& a, const Move& b) {
+    return std::tie(a.from, a.to, a.flags, a.promo) < std::tie(b.from, b.to, b.flags, b.promo);
+}
+
+// Walks the tree with the make/undo filter and checks the masked generator
+// produces exactly the same move set at every node.
+static uint64_t compare_tree(Position& pos, int depth) {
+    std::vector<Move> reference, masked;
+    generateLegalAllMovesMakeUndo(pos, reference);
+    generateLegalMoves(pos, masked);
+    std::sort(reference.begin(), reference.end(), move_less);
+    std::sort(masked.begin(), masked.end(), move_less);
+    assert(reference == masked);
+    assert(hasLegalMove(pos) == !reference.empty());
+    if (depth == 1) return reference.size();
+
+    uint64_t nodes = 0;
+    for (const auto& m : reference) {
+        makeMove(pos, m);
+        nodes += compare_tree(pos, depth - 1);
+        UndoMove(pos);
+    }
+    return nodes;
+}
+
+template <typename Gen>
+static uint64_t perft(Position& pos, int depth, Gen gen) {
+    std::vector<Move> moves;
+    gen(pos, moves);
+    if (depth == 1) return static_cast<uint64_t>(moves.size());
+
+    uint64_t nodes = 0;
+    for (const auto& m : moves) {
+        makeMove(pos, m);
+        nodes += perft(pos, depth - 1, gen);
+        UndoMove(pos);
+    }
+    return nodes;
+}
+
+int main() {
+    struct Case { const char* fen; int depth; uint64_t nodes; };
+    const Case cases[] = {
+        {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 3, 8902ULL},
+        {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 3, 97862ULL},
+        {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 4, 43238ULL},
+        {"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 3, 9467ULL},
+        {"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 3, 62379ULL},
+        {"r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 3, 89890ULL},
+        // En passant that would expose the king along the rank, and a pinned e.p. pawn.
+        {"8/8/8/KPp4r/8/8/8/7k w - c6 0 2", 1, 4ULL},
+        {"8/8/8/8/k2Pp2Q/8/8/3K4 b - d3 0 1", 1, 6ULL},
+        // Castling through and out of attacked squares.
+        {"r3k2r/8/8/8/8/8/8/R3K1r1 w Qkq - 0 1", 1, 3ULL},
+        {"r3k2r/8/8/8/8/8/5r2/R3K2R w KQkq - 0 1", 2, 737ULL},
+    };
+
+    for (const auto& c : cases) {
+        Position p;
+        bool ok = loadFEN(p, c.fen);
+        assert(ok);
+        uint64_t nodes = compare_tree(p, c.depth);
+        assert(nodes == c.nodes);
+    }
+
+    // hasLegalMove where the answer hangs on a single move, or on none.
+    struct AnyCase { const char* fen; bool any; };
+    const AnyCase any_cases[] = {
+        {"7k/5Q2/6K1/8/8/8/8/8 b - - 0 1", false},              // stalemate
+        {"rnb1kbnr/pppp1ppp/8/4p3/6Pq/5P2/PPPPP2P/RNBQKBNR w KQkq - 1 3", false}, // mate
+        {"4k3/8/8/8/8/3n4/3PPP2/r3K3 w - - 0 1", false},        // double check, no escape
+        {"7k/8/8/8/8/8/p7/K7 w - - 0 1", true},                 // only the king
+        {"k7/2Q5/1K6/8/8/8/8/7R b - - 0 1", false},             // stalemate
+        {"k7/P7/K7/8/3Pp3/4P3/8/8 b - d3 0 1", true},           // only en passant
+        {"k7/8/1K6/8/8/8/8/8 b - - 0 1", true},                 // only a king step
+        {"k7/P7/K7/8/8/8/8/8 b - - 0 1", false},                // blocked pawn, no step
+    };
+    for (const auto& c : any_cases) {
+        Position p;
+        bool ok = loadFEN(p, c.fen);
+        assert(ok);
+        (void)ok;
+        std::vector<Move> moves;
+        generateLegalMoves(p, moves);
+        assert(moves.empty() != c.any);
+        assert(hasLegalMove(p) == c.any);
+    }
+
+    // Speed comparison on the perft suite's start position and Kiwipete.
+    for (int i = 0; i < 2; ++i) {
+        Position p;
+        loadFEN(p, cases[i].fen);
+        int depth = i == 0 ? 4 : 3;
+        auto t0 = std::chrono::steady_clock::now();
+        uint64_t slow = perft(p, depth, generateLegalAllMovesMakeUndo);
+        auto t1 = std::chrono::steady_clock::now();
+        uint64_t fast = perft(p, depth, [](Position& pos, std::vector<Move>& l) { generateLegalMoves(pos, l); });
+        auto t2 = std::chrono::steady_clock::now();
+        assert(slow == fast);
+        double slow_ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+        double fast_ms = std::chrono::duration<double, std::milli>(t2 - t1).count();
+        std::cout << "perft(" << depth << ") " << cases[i].fen << "\n"
+                  << "  make/undo filter=" << slow_ms << "ms"
+                  << "  masked=" << fast_ms << "ms"
+                  << "  speedup=" << (fast_ms > 0 ? slow_ms / fast_ms : 0.0) << "x\n";
+    }
+    return 0;
+}
@@ -0,0 +1,88 @@
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <vector>
+#include "chess/attacks.hpp"
+#include "chess/magic.hpp"
+#include "chess/position.hpp"
+#include "chess/move.hpp"
+#include "chess/movegen.hpp"
+#include "chess/make_undo.hpp"
+#include "chess/fen.hpp"
+
+static uint64_t perft(Position& pos, int depth) {
+    std::vector<Move> moves;
+    generateLegalAllMoves(pos, moves);
+    if (depth == 1) return static_cast<uint64_t>(moves.size());
+
+    uint64_t nodes = 0;
+    for (const auto& m : moves) {
+        makeMove(pos, m);
+        nodes += perft(pos, depth - 1);
+        UndoMove(pos);
+    }
+    return nodes;
+}
+
+static double timed_perft(Position& pos, int depth, uint64_t& nodes) {
+    auto t0 = std::chrono::steady_clock::now();
+    nodes = perft(pos, depth);
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t1 - t0).count();
+}
+
+int main() {
+    // Magic lookups must agree with the ray walker for random occupancies.
+    uint64_t s = 0x9E3779B97F4A7C15ULL;
+    auto next = [&s]() {
+        s ^= s << 13; s ^= s >> 7; s ^= s << 17;
+        return s;
+    };
+    for (int sq = 0; sq < 64; ++sq) {
+        for (int i = 0; i < 2000; ++i) {
+            Bitboard occ = next() & next();
+            assert(magicRookAttacks(sq, occ) == computeRookMoveRay(sq, occ));
+            assert(magicBishopAttacks(sq, occ) == computeBishopMoveRay(sq, occ));
+#ifdef CHESS_USE_PEXT
+            if (pextAvailable()) {
+                assert(pextRookAttacks(sq, occ) == computeRookMoveRay(sq, occ));
+                assert(pextBishopAttacks(sq, occ) == computeBishopMoveRay(sq, occ));
+            }
+#endif
+        }
+    }
+
+    // Perft-level comparison of every available backend against the ray walker.
+    const char* fens[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    };
+    const int depths[] = {4, 3};
+    const SliderBackend backends[] = {SliderBackend::RayWalk, SliderBackend::Magic, SliderBackend::Pext};
+    const char* names[] = {"ray", "magic", "pext"};
+    const SliderBackend original = sliderBackend();
+    for (int i = 0; i < 2; ++i) {
+        Position p;
+        bool ok = loadFEN(p, fens[i]);
+        assert(ok);
+
+        std::cout << "perft(" << depths[i] << ") " << fens[i] << "\n";
+        uint64_t ray_nodes = 0;
+        double ray_ms = 0;
+        for (int b = 0; b < 3; ++b) {
+            if (!setSliderBackend(backends[b])) {
+                std::cout << "  " << names[b] << ": unavailable\n";
+                continue;
+            }
+            uint64_t nodes = 0;
+            double ms = timed_perft(p, depths[i], nodes);
+            if (b == 0) { ray_nodes = nodes; ray_ms = ms; }
+            assert(nodes == ray_nodes);
+            std::cout << "  " << names[b] << ": nodes=" << nodes << "  " << ms << "ms"
+                      << "  speedup=" << (ms > 0 ? ray_ms / ms : 0.0) << "x\n";
+        }
+    }
+    setSliderBackend(original);
+    return 0;
+}
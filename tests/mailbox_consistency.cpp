@@ -0,0 +1,51 @@
+#include <cassert>
+#include <cstdint>
+#include "chess/position.hpp"
+#include "chess/move.hpp"
+#include "chess/movegen.hpp"
+#include "chess/make_undo.hpp"
+#include "chess/fen.hpp"
+
+static uint64_t perft_checked(Position& pos, int depth) {
+    assert(positionConsistent(pos));
+    MoveList moves;
+    generateLegalAllMoves(pos, moves);
+    if (depth == 1) return moves.size();
+
+    uint64_t nodes = 0;
+    for (const auto& m : moves) {
+        makeMove(pos, m);
+        nodes += perft_checked(pos, depth - 1);
+        UndoMove(pos);
+        assert(positionConsistent(pos));
+    }
+    return nodes;
+}
+
+int main() {
+    Position p;
+    p.start_position();
+    assert(positionConsistent(p));
+    assert(getPiece(p, get_index('e', 1)) == WK);
+    assert(getPiece(p, get_index('d', 8)) == BQ);
+    assert(getPiece(p, get_index('e', 4)) == EMPTY);
+
+    // A stale mailbox entry must be detected.
+    p.board[get_index('e', 4)] = WQ;
+    assert(!positionConsistent(p));
+
+    bool ok = loadFEN(p, "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    assert(ok);
+    assert(perft_checked(p, 3) == 97862ULL);
+
+    ok = loadFEN(p, "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1");
+    assert(ok);
+    assert(perft_checked(p, 3) == 9467ULL);
+
+    // removePiece hands back what was on the square and empties it.
+    assert(removePiece(p, get_index('a', 8)) == BR);
+    assert(getPiece(p, get_index('a', 8)) == EMPTY);
+    assert(removePiece(p, get_index('a', 8)) == EMPTY);
+    assert(positionConsistent(p));
+    return 0;
+}
@@ -0,0 +1,140 @@
+#include <cassert>
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <tuple>
+#include <vector>
+#include "chess/position.hpp"
+#include "chess/move.hpp"
+#include "chess/movegen.hpp"
+#include "chess/movepick.hpp"
+#include "chess/make_undo.hpp"
+#include "chess/see.hpp"
+#include "chess/fen.hpp"
+
+static bool move_less(const Move& a, const Move& b) {
+    return std::tie(a.from, a.to, a.flags, a.promo) < std::tie(b.from, b.to, b.flags, b.promo);
+}
+
+static bool noisy(const Move& m) {
+    return (m.flags & (CAPTURE | EN_PASSANT | PROMOTION)) != 0;
+}
+
+// Stage order the main-search picker must respect.
+static int rank_of(MovePicker::Stage s) {
+    switch (s) {
+    case MovePicker::STAGE_FIRST: return 0;
+    case MovePicker::STAGE_GOOD_CAPTURES: return 1;
+    case MovePicker::STAGE_KILLERS: return 2;
+    case MovePicker::STAGE_QUIETS: return 3;
+    case MovePicker::STAGE_BAD_CAPTURES: return 4;
+    default: assert(false); return -1;
+    }
+}
+
+// With arbitrary (often illegal) TT moves and killers, the picker must
+// return exactly the legal moves, once each, stage by stage.
+static uint64_t check_picker(Position& pos, int depth, uint64_t& salt, const HistoryTable& history) {
+    MoveList legal;
+    generateLegalMoves(pos, legal);
+
+    // Every legal move is recognised; a random packed move only if it is one of them.
+    for (const Move& m : legal) assert(isLegalMove(pos, packMove(m)));
+    salt = salt * 6364136223846793005ULL + 1442695040888963407ULL;
+    PackedMove random_move;
+    random_move.data = static_cast<uint16_t>(salt >> 48);
+    bool listed = false;
+    for (const Move& m : legal) listed |= packMove(m) == random_move;
+    assert(isLegalMove(pos, random_move) == (listed && !random_move.isNone()));
+
+    PackedMove first = legal.empty() ? PackedMove{} : packMove(legal[static_cast<int>((salt >> 20) % legal.size())]);
+    if ((salt >> 8) % 4 == 0) first = random_move;
+    PackedMove killers[2] = {random_move, legal.empty() ? PackedMove{} : packMove(legal[0])};
+
+    MovePicker picker(pos, first, killers, history);
+    std::vector<Move> seen;
+    Move m;
+    int last_rank = 0;
+    while (picker.next(m)) {
+        int rank = rank_of(picker.lastStage());
+        assert(rank >= last_rank);
+        last_rank = rank;
+        if (rank == 0) assert(packMove(m) == first);
+        if (rank == 1) assert(noisy(m) && see(pos, m) >= 0);
+        if (rank == 2 || rank == 3) assert(!noisy(m));
+        if (rank == 4) assert(noisy(m) && see(pos, m) < 0);
+        seen.push_back(m);
+    }
+    std::vector<Move> expected(legal.begin(), legal.end());
+    std::sort(seen.begin(), seen.end(), move_less);
+    std::sort(expected.begin(), expected.end(), move_less);
+    assert(seen == expected);
+
+    if (depth == 1) return legal.size();
+    uint64_t nodes = 0;
+    for (const Move& mv : legal) {
+        makeMove(pos, mv);
+        nodes += check_picker(pos, depth - 1, salt, history);
+        UndoMove(pos);
+    }
+    return nodes;
+}
+
+int main() {
+    HistoryTable history;
+    const char* fens[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    };
+    uint64_t salt = 1;
+    for (const char* fen : fens) {
+        Position pos;
+        bool ok = loadFEN(pos, fen);
+        assert(ok);
+        (void)ok;
+        check_picker(pos, 3, salt, history);
+    }
+
+    // Quiets come out by history score.
+    Position pos;
+    bool ok = loadFEN(pos, "4k3/8/8/8/8/8/8/R3K3 w - - 0 1");
+    assert(ok);
+    (void)ok;
+    Move a1a5{get_index('a', 1), get_index('a', 5), 0, NO_PROMO, -1};
+    Move e1f2{get_index('e', 1), get_index('f', 2), 0, NO_PROMO, -1};
+    history.update(WHITE, packMove(a1a5), 400);
+    history.update(WHITE, packMove(e1f2), 100);
+    MovePicker quiet_picker(pos, PackedMove{}, nullptr, history);
+    Move m;
+    ok = quiet_picker.next(m);
+    assert(ok && m == a1a5);
+    ok = quiet_picker.next(m);
+    assert(ok && m == e1f2);
+
+    // Quiescence picker: winning and equal captures by victim, losing ones dropped.
+    ok = loadFEN(pos, "4k3/8/3p4/2r1n3/3Q4/8/8/4K3 w - - 0 1");
+    assert(ok);
+    MovePicker qs_picker(pos);
+    std::vector<Move> qs;
+    while (qs_picker.next(m)) qs.push_back(m);
+    // Qxc5 is defended by d6 (rook for queen loses), Qxe5 likewise, Qxd6 is free.
+    assert(qs.size() == 1 && qs[0].to == get_index('d', 6));
+
+    // Quiet underpromotions only in the main search; quiescence gets b8=Q.
+    ok = loadFEN(pos, "4k3/1P6/8/8/8/8/8/4K3 w - - 0 1");
+    assert(ok);
+    int promotions = 0;
+    MovePicker main_picker(pos, PackedMove{}, nullptr, history);
+    while (main_picker.next(m)) promotions += (m.flags & PROMOTION) != 0;
+    assert(promotions == 4);
+    MovePicker qs_promo(pos);
+    qs.clear();
+    while (qs_promo.next(m)) qs.push_back(m);
+    assert(qs.size() == 1 && qs[0].promo == PROMO_Q);
+    (void)promotions;
+
+    std::cout << "move_picker passed\n";
+    return 0;
+}
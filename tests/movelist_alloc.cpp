@@ -0,0 +1,55 @@
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include "chess/position.hpp"
+#include "chess/move.hpp"
+#include "chess/movegen.hpp"
+#include "chess/make_undo.hpp"
+#include "chess/fen.hpp"
+
+// Count every heap allocation made by the process.
+static std::size_t g_allocations = 0;
+
+void* operator new(std::size_t n) {
+    ++g_allocations;
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+static uint64_t perft(Position& pos, int depth) {
+    MoveList moves;
+    generateLegalAllMoves(pos, moves);
+    if (depth == 1) return static_cast<uint64_t>(moves.size());
+
+    uint64_t nodes = 0;
+    for (const auto& m : moves) {
+        makeMove(pos, m);
+        nodes += perft(pos, depth - 1);
+        UndoMove(pos);
+    }
+    return nodes;
+}
+
+int main() {
+    Position p;
+    bool ok = loadFEN(p, "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    assert(ok);
+    (void)ok;
+
+    // First pass grows the undo and repetition stacks to their working size.
+    uint64_t warm = perft(p, 3);
+    assert(warm == 97862ULL);
+    (void)warm;
+
+    std::size_t before = g_allocations;
+    uint64_t nodes = perft(p, 3);
+    std::size_t allocations = g_allocations - before;
+    std::cout << "nodes=" << nodes << "  heap allocations=" << allocations << "\n";
+    assert(nodes == 97862ULL);
+    assert(allocations == 0);
+    return 0;
+}
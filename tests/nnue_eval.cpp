@@ -0,0 +1,118 @@
+#include <cassert>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include "chess/position.hpp"
+#include "chess/move.hpp"
+#include "chess/movegen.hpp"
+#include "chess/make_undo.hpp"
+#include "chess/attacks.hpp"
+#include "chess/nnue.hpp"
+#include "chess/search.hpp"
+#include "chess/fen.hpp"
+
+static bool same_values(const Nnue::Accumulator& a, const Nnue::Accumulator& b) {
+    return std::memcmp(a.values, b.values, sizeof(a.values)) == 0;
+}
+
+// Walks the tree with an AccumulatorStack as the search drives it: a push
+// after every move, null moves included, and an evaluation only at every
+// other ply, so updates have to catch up over several plies. Every
+// accumulator evaluated must match one built from the board.
+static void walk(const Nnue::Network& net, Nnue::AccumulatorStack& stack, Position& pos, int ply, int depth) {
+    if (ply % 2 == 0 || depth == 0) {
+        int score = stack.evaluate(ply, pos);
+        Nnue::Accumulator fresh;
+        Nnue::refresh(net, pos, WHITE, fresh);
+        Nnue::refresh(net, pos, BLACK, fresh);
+        assert(same_values(stack.at(ply), fresh));
+        assert(score == Nnue::evaluate(net, pos));
+        (void)score;
+    }
+    if (depth == 0) return;
+
+    if (depth >= 2 && !isKinginCheck(pos.side_to_move, pos)) {
+        makeNullMove(pos, defaultStateStack());
+        stack.push(ply + 1, pos);
+        walk(net, stack, pos, ply + 1, depth - 1);
+        undoNullMove(pos, defaultStateStack());
+    }
+    MoveList moves;
+    generateLegalMoves(pos, moves);
+    for (const Move& m : moves) {
+        makeMove(pos, m);
+        stack.push(ply + 1, pos);
+        walk(net, stack, pos, ply + 1, depth - 1);
+        UndoMove(pos);
+    }
+}
+
+static int eval_fen(const Nnue::Network& net, const char* fen) {
+    Position pos;
+    bool ok = loadFEN(pos, fen);
+    assert(ok);
+    (void)ok;
+    return Nnue::evaluate(net, pos);
+}
+
+int main() {
+    Nnue::Network missing;
+    std::string error;
+    bool ok = missing.load("no/such/file.nnue", &error);
+    assert(!ok && !missing.loaded() && !error.empty());
+
+    Nnue::Network net;
+    ok = net.load(CHESS_TEST_NET, &error);
+    if (!ok) std::cerr << error << "\n";
+    assert(ok && net.loaded());
+
+    // The test net scores material: the start position is level, and it
+    // agrees with itself with colours and side to move swapped.
+    int start = eval_fen(net, "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1");
+    assert(start > -30 && start < 30);
+    (void)start;
+    assert(eval_fen(net, "4k3/8/8/8/8/8/8/3QK3 w - - 0 1") > 700);
+    assert(eval_fen(net, "4k3/8/8/8/8/8/8/3QK3 b - - 0 1") < -700);
+    assert(eval_fen(net, "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3") ==
+           eval_fen(net, "rnbqkb1r/pppp1ppp/5n2/4p3/4P3/2N5/PPPP1PPP/R1BQKBNR b KQkq - 2 3"));
+
+    const char* fens[] = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    };
+    Nnue::AccumulatorStack stack(net, 16);
+    for (const char* fen : fens) {
+        Position pos;
+        ok = loadFEN(pos, fen);
+        assert(ok);
+        stack.reset(pos);
+        walk(net, stack, pos, 0, 3);
+
+        // Every SIMD kernel the CPU has gives the scalar result.
+        Nnue::Accumulator acc;
+        Nnue::refresh(net, pos, WHITE, acc);
+        Nnue::refresh(net, pos, BLACK, acc);
+        for (Color stm : {WHITE, BLACK}) {
+            int scalar = Nnue::forward(net, acc, stm, Nnue::Simd::Scalar);
+            for (Nnue::Simd simd : {Nnue::Simd::Sse41, Nnue::Simd::Avx2})
+                if (Nnue::available(simd)) assert(Nnue::forward(net, acc, stm, simd) == scalar);
+            (void)scalar;
+        }
+    }
+
+    // The search picks up a free queen with the network as its evaluation.
+    Position pos;
+    ok = loadFEN(pos, "4k3/8/8/3q4/8/8/8/3RK3 w - - 0 1");
+    assert(ok);
+    SearchLimits limits;
+    limits.depth = 4;
+    limits.network = &net;
+    SearchResult r = search(pos, limits);
+    assert(r.has_move && r.best_move.from == get_index('d', 1) && r.best_move.to == get_index('d', 5));
+    assert(r.score > 300);
+
+    std::cout << "nnue_eval passed\n";
+    return 0;
+}
@@ -0,0 +1,54 @@
+#include <cassert>
+#include <cstdint>
+#include "chess/position.hpp"
+#include "chess/move.hpp"
+#include "chess/movegen.hpp"
+#include "chess/make_undo.hpp"
+#include "chess/fen.hpp"
+
+static_assert(sizeof(PackedMove) == 2, "PackedMove must stay 16 bits");
+
+// Every generated move must survive Move -> PackedMove -> Move unchanged, and
+// the packed generator overload must yield the same list.
+static uint64_t walk(Position& pos, int depth) {
+    MoveList moves;
+    PackedMoveList packed;
+    generateLegalMoves(pos, moves);
+    generateLegalMoves(pos, packed);
+    assert(moves.size() == packed.size());
+    for (int i = 0; i < moves.count; ++i) {
+        Move back = unpackMove(packMove(moves[i]));
+        assert(back == moves[i]);
+        assert(back.captured == moves[i].captured);
+        assert(packed[i] == packMove(moves[i]));
+        assert(!packed[i].isNone());
+    }
+    if (depth == 1) return moves.size();
+
+    uint64_t nodes = 0;
+    for (const auto& pm : packed) {
+        makeMove(pos, unpackMove(pm));
+        nodes += walk(pos, depth - 1);
+        UndoMove(pos);
+    }
+    return nodes;
+}
+
+int main() {
+    // Kiwipete covers castling and e.p.; position 4 covers every promotion kind.
+    Position p;
+    bool ok = loadFEN(p, "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    assert(ok);
+    assert(walk(p, 3) == 97862ULL);
+
+    ok = loadFEN(p, "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1");
+    assert(ok);
+    assert(walk(p, 3) == 9467ULL);
+
+    Move promo{get_index('b', 7), get_index('a', 8), CAPTURE | PROMOTION, PROMO_N, -1};
+    PackedMove pm = packMove(promo);
+    assert(pm.from() == promo.from && pm.to() == promo.to);
+    assert(pm.kind() == KIND_PROMO_CAPTURE);
+    assert(unpackMove(pm) == promo);
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include "chess/position.hpp"
+#include "chess/move.hpp"
+#include "chess/movegen.hpp"
+#include "chess/make_undo.hpp"
+#include "chess/eval.hpp"
+#include "chess/pawns.hpp"
+#include "chess/search.hpp"
+#include "chess/tt.hpp"
+#include "chess/fen.hpp"
+
+// Cached and uncached evaluation agree everywhere, even with a table small
+// enough that structures keep evicting each other.
+static void walk(Position& pos, int depth, PawnTable& table) {
+    assert(evaluate(pos, table) == evaluate(pos));
+    assert(evaluate(pos, table) == evaluateFromScratch(pos));
+    if (depth == 0) return;
+    MoveList moves;
+    generateLegalMoves(pos, moves);
+    for (const Move& m : moves) {
+        makeMove(pos, m);
+        walk(pos, depth - 1, table);
+        UndoMove(pos);
+    }
+}
+
+static PawnEntry pawns_of(const char* fen) {
+    Position pos;
+    bool ok = loadFEN(pos, fen);
+    assert(ok);
+    (void)ok;
+    PawnEntry e;
+    evaluatePawns(pos, e);
+    assert(e.check == PawnEntry::checkOf(pos.pawn_key));
+    return e;
+}
+
+int main() {
+    // Passed pawns: d5 for white (nothing on c-e ahead), a7 for black; the
+    // f-h pawns face each other.
+    PawnEntry e = pawns_of("4k3/p4ppp/8/3P4/8/8/5PPP/4K3 w - - 0 1");
+    assert(e.passed[WHITE] == convert_to_bit(get_index('d', 5)));
+    assert(e.passed[BLACK] == convert_to_bit(get_index('a', 7)));
+
+    // Doubled and isolated pawns cost, symmetrically for both colours.
+    PawnEntry healthy = pawns_of("4k3/5ppp/8/8/8/8/5PPP/4K3 w - - 0 1");
+    PawnEntry doubled = pawns_of("4k3/5ppp/8/8/8/6P1/5PP1/4K3 w - - 0 1");
+    PawnEntry isolated = pawns_of("4k3/5ppp/8/8/8/8/P5PP/4K3 w - - 0 1");
+    assert(healthy.mg == 0 && healthy.eg == 0);
+    assert(doubled.eg < 0 && isolated.mg < 0);
+    PawnEntry mirrored = pawns_of("4k3/p5pp/8/8/8/8/5PPP/4K3 w - - 0 1");
+    assert(mirrored.mg == -isolated.mg && mirrored.eg == -isolated.eg);
+
+    // Backward: d3 has no pawn beside or behind it, and with the black pawn
+    // on e5 rather than e6 its advance square d4 is guarded. Nothing else
+    // differs between the two.
+    PawnEntry backward = pawns_of("4k3/8/8/4p3/2P5/3P4/8/4K3 w - - 0 1");
+    PawnEntry unguarded = pawns_of("4k3/8/4p3/8/2P5/3P4/8/4K3 w - - 0 1");
+    assert(backward.mg < unguarded.mg && backward.eg < unguarded.eg);
+
+    PawnTable tiny(1);
+    const char* fens[] = {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    };
+    for (const char* fen : fens) {
+        Position pos;
+        bool ok = loadFEN(pos, fen);
+        assert(ok);
+        (void)ok;
+        walk(pos, 3, tiny);
+    }
+    assert(tiny.hits() <= tiny.probes() && tiny.probes() > 0);
+
+    // A real search hits the pawn table far more often than it misses, even
+    // starting cold. The tables outlive it, so the next search, from the
+    // position after the reply, starts warm and misses less still.
+    Position pos;
+    bool ok = loadFEN(pos, fens[0]);
+    assert(ok);
+    (void)ok;
+    SearchLimits limits;
+    limits.depth = 6;
+    PawnTables tables;
+    TranspositionTable tt(16);
+    SearchResult cold = search(pos, defaultStateStack(), tt, tables, limits);
+    assert(cold.pawn_probes > 0 && cold.pawnHitRate() > 0.8);
+    assert(cold.pawn_probes == tables.thread(0).probes());
+    makeMove(pos, cold.best_move);
+    tt.clear();
+    SearchResult warm = search(pos, defaultStateStack(), tt, tables, limits);
+    assert(warm.pawn_probes > 0 && warm.pawnHitRate() > cold.pawnHitRate());
+    UndoMove(pos);
+
+    std::cout << "pawn_hash passed\n";
+    return 0;
+}
@@ -0,0 +1,72 @@
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include "chess/position.hpp"
+#include "chess/make_undo.hpp"
+#include "chess/perft.hpp"
+#include "chess/fen.hpp"
+
+int main() {
+    const char* fens[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    };
+    const int depths[] = {5, 4, 5};
+
+    // A 1 MB table forces plenty of replacement; counts must still be exact,
+    // and a second pass over a warm table must hit at the root.
+    for (int i = 0; i < 3; i++) {
+        Position pos;
+        bool ok = loadFEN(pos, fens[i]);
+        assert(ok);
+        (void)ok;
+        std::uint64_t serial = perft(pos, depths[i]);
+
+        for (bool verify : {false, true}) {
+            PerftTable table(1, verify);
+            StateStack state;
+            state.reset(pos);
+            PerftHashStats stats;
+            std::uint64_t nodes = perftHashed(pos, state, depths[i], table, stats);
+            assert(nodes == serial);
+            assert(stats.hits > 0 && stats.collisions == 0);
+
+            PerftHashStats warm;
+            nodes = perftHashed(pos, state, depths[i], table, warm);
+            assert(nodes == serial);
+            assert(warm.probes == 1 && warm.hits == 1);
+            (void)nodes;
+
+            // Threads racing on the same entries tear each other's writes;
+            // those are misses, not collisions.
+            table.clear();
+            ParallelPerftResult r = perftParallel(pos, depths[i], 4, 0, &table);
+            assert(r.nodes == serial);
+            PerftHashStats shared;
+            for (const PerftThreadStats& t : r.threads) shared.add(t.hash);
+            assert(shared.probes > 0 && shared.collisions == 0);
+        }
+        std::cout << fens[i] << " depth " << depths[i] << ": " << serial << " ok\n";
+    }
+
+    // Two different positions forced onto the same Zobrist key: a plain table
+    // returns the wrong count, verify mode rejects it and reports a collision.
+    Position a, b;
+    loadFEN(a, fens[0]);
+    loadFEN(b, fens[1]);
+    b.zobrist = a.zobrist;
+    for (bool verify : {false, true}) {
+        PerftTable table(1, verify);
+        PerftHashStats stats;
+        table.store(a, 3, perft(a, 3), stats);
+        std::uint64_t nodes = 0;
+        bool hit = table.probe(b, 3, nodes, stats);
+        assert(hit == !verify);
+        assert(stats.collisions == (verify ? 1u : 0u));
+        // Same key at another depth is a different entry.
+        assert(!table.probe(a, 2, nodes, stats));
+    }
+    std::cout << "perft_hash passed\n";
+    return 0;
+}
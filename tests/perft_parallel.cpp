@@ -0,0 +1,49 @@
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include "chess/position.hpp"
+#include "chess/perft.hpp"
+#include "chess/fen.hpp"
+
+// Parallel perft must match the serial counts for any thread count and split
+// ply, and every subtree must be searched exactly once.
+int main() {
+    const char* fens[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        // Mate in one for black: leaves drop out above the split ply.
+        "rnbqkbnr/pppp1ppp/8/4p3/6P1/5P2/PPPPP2P/RNBQKBNR b KQkq - 0 2",
+    };
+    const int depths[] = {4, 3, 5, 3};
+
+    for (int i = 0; i < 4; i++) {
+        Position pos;
+        bool ok = loadFEN(pos, fens[i]);
+        assert(ok);
+        (void)ok;
+        std::uint64_t serial = perft(pos, depths[i]);
+
+        for (int threads : {1, 2, 3, 8}) {
+            for (int split : {0, 1, 2}) {
+                ParallelPerftResult r = perftParallel(pos, depths[i], threads, split);
+                assert(r.nodes == serial);
+                assert((int)r.threads.size() == threads);
+                std::uint64_t sum = 0, tasks = 0;
+                for (const auto& t : r.threads) {
+                    sum += t.nodes;
+                    tasks += t.tasks;
+                }
+                assert(sum == serial);
+                assert(tasks == r.tasks);
+                if (split > 0) assert(r.split_ply == split);
+            }
+        }
+        // The root position is left untouched and depth 0/1 still work.
+        assert(perftParallel(pos, 1, 4).nodes == perft(pos, 1));
+        assert(perftParallel(pos, 0, 4).nodes == 1);
+        std::cout << fens[i] << " depth " << depths[i] << ": " << serial << " ok\n";
+    }
+    std::cout << "perft_parallel passed\n";
+    return 0;
+}
@@ -0,0 +1,124 @@
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include "chess/position.hpp"
+#include "chess/move.hpp"
+#include "chess/movegen.hpp"
+#include "chess/make_undo.hpp"
+#include "chess/search.hpp"
+#include "chess/fen.hpp"
+#include "chess/cli.hpp"
+
+static SearchResult run(const char* fen, SearchLimits limits) {
+    Position pos;
+    bool ok = loadFEN(pos, fen);
+    assert(ok);
+    (void)ok;
+    std::string before = saveFEN(pos);
+    std::uint64_t key = pos.zobrist;
+    SearchResult r = search(pos, limits);
+    // The search must leave the position and the game stack untouched.
+    assert(saveFEN(pos) == before && pos.zobrist == key);
+    assert(defaultStateStack().moves.empty());
+    return r;
+}
+
+// Every PV move must be legal in the position it is played from.
+static void check_pv(const char* fen, const std::vector<Move>& pv) {
+    Position pos;
+    loadFEN(pos, fen);
+    for (const Move& m : pv) {
+        MoveList legal;
+        generateLegalMoves(pos, legal);
+        bool found = false;
+        for (const Move& l : legal) found = found || l == m;
+        assert(found);
+        makeMove(pos, m);
+    }
+}
+
+int main() {
+    SearchLimits limits;
+    limits.depth = 4;
+
+    // Back-rank mate in one.
+    const char* mate1 = "6k1/5ppp/8/8/8/8/8/R5K1 w - - 0 1";
+    SearchResult r = run(mate1, limits);
+    assert(r.has_move && move_to_uci(r.best_move) == "a1a8");
+    assert(r.score == MATE_SCORE - 1);
+    check_pv(mate1, r.pv);
+
+    // King and rook mate in two: the score must say mate in 3 plies.
+    const char* mate2 = "k7/8/1K6/8/8/8/8/1R6 w - - 0 1";
+    limits.depth = 6;
+    r = run(mate2, limits);
+    assert(r.has_move && r.score == MATE_SCORE - 3);
+    check_pv(mate2, r.pv);
+
+    // Getting mated: black to move can only delay.
+    const char* mated = "k7/2K5/8/8/8/8/8/1R6 b - - 0 1";
+    limits.depth = 4;
+    r = run(mated, limits);
+    assert(r.has_move && r.score == -(MATE_SCORE - 2));
+
+    // Free queen.
+    const char* hanging = "4k3/8/8/3q4/8/8/3R4/4K3 w - - 0 1";
+    limits.depth = 3;
+    r = run(hanging, limits);
+    assert(move_to_uci(r.best_move) == "d2d5");
+
+    // Horizon: at depth 1 the pawn on d5 looks free, but quiescence sees
+    // the recapture, so the queen must not take it.
+    const char* defended = "4k3/8/4p3/3p4/8/8/8/3QK3 w - - 0 1";
+    limits.depth = 1;
+    r = run(defended, limits);
+    assert(move_to_uci(r.best_move) != "d1d5" && r.qnodes > 0 && r.qnodes < r.nodes);
+    limits.depth = 3;
+
+    // Root already decided: no move, mate and stalemate scores.
+    r = run("R5k1/5ppp/8/8/8/8/8/6K1 b - - 0 1", limits);
+    assert(!r.has_move && r.score == -MATE_SCORE);
+    r = run("k7/2Q5/1K6/8/8/8/8/8 b - - 0 1", limits);
+    assert(!r.has_move && r.score == 0);
+
+    // Node limit: stops close to the budget and still returns a legal move.
+    const char* kiwipete = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+    SearchLimits budget;
+    budget.nodes = 5000;
+    r = run(kiwipete, budget);
+    assert(r.stopped && r.has_move && r.nodes <= budget.nodes);
+    check_pv(kiwipete, {r.best_move});
+
+    // Iterations are reported in order with growing node counts.
+    limits.depth = 4;
+    int last_depth = 0;
+    Position pos;
+    loadFEN(pos, kiwipete);
+    r = search(pos, limits, [&](const SearchIteration& it) {
+        assert(it.depth == last_depth + 1);
+        last_depth = it.depth;
+    });
+    assert(last_depth == 4 && r.depth == 4 && r.iterations.size() == 4);
+    for (std::size_t i = 1; i < r.iterations.size(); i++)
+        assert(r.iterations[i].nodes > r.iterations[i - 1].nodes);
+    check_pv(kiwipete, r.pv);
+
+    // Pruning and reductions change the node count, never a forced mate,
+    // and switched off they leave plain alpha-beta.
+    SearchLimits plain;
+    plain.depth = 6;
+    plain.null_move = plain.lmr = plain.futility = plain.reverse_futility = plain.aspiration = false;
+    SearchLimits pruned;
+    pruned.depth = 6;
+    SearchResult slow = run(mate2, plain), fast = run(mate2, pruned);
+    assert(slow.score == MATE_SCORE - 3 && fast.score == MATE_SCORE - 3);
+    // Pruned first, so the plain search is the one that finds a warm table.
+    fast = run(kiwipete, pruned);
+    slow = run(kiwipete, plain);
+    assert(fast.nodes < slow.nodes);
+    check_pv(kiwipete, fast.pv);
+
+    std::cout << "search_basic passed\n";
+    return 0;
+}
@@ -0,0 +1,95 @@
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "chess/position.hpp"
+#include "chess/move.hpp"
+#include "chess/movegen.hpp"
+#include "chess/make_undo.hpp"
+#include "chess/search.hpp"
+#include "chess/tt.hpp"
+#include "chess/fen.hpp"
+#include "chess/cli.hpp"
+
+// Writers hammer a tiny shared table with entries whose score and depth are
+// a function of the key. Whatever a reader gets back must belong to the key
+// it asked for: torn entries have to read as misses.
+static void hammer_table() {
+    TranspositionTable tt(1);
+    tt.newSearch();
+    auto worker = [&tt](std::uint64_t seed) {
+        std::uint64_t x = seed;
+        for (int i = 0; i < 200000; i++) {
+            x ^= x << 13; x ^= x >> 7; x ^= x << 17;
+            std::uint64_t key = x % 50000 + 1;
+            TTData d;
+            if (tt.probe(key, d))
+                assert(d.score == static_cast<int>(key % 20000) && d.depth == static_cast<int>(key % 100));
+            tt.store(key, PackedMove{static_cast<std::uint16_t>(key)}, key % 20000, key % 100, BOUND_EXACT);
+        }
+    };
+    std::vector<std::thread> pool;
+    for (std::uint64_t t = 1; t <= 4; t++)
+        pool.emplace_back(worker, t * 0x9E3779B97F4A7C15ULL);
+    for (auto& t : pool) t.join();
+}
+
+static bool is_legal(const char* fen, const Move& m) {
+    Position pos;
+    loadFEN(pos, fen);
+    MoveList legal;
+    generateLegalMoves(pos, legal);
+    for (const Move& l : legal)
+        if (l == m) return true;
+    return false;
+}
+
+int main() {
+    hammer_table();
+
+    const char* kiwipete = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+    for (int threads : {1, 2, 4}) {
+        Position pos;
+        loadFEN(pos, kiwipete);
+        std::string before = saveFEN(pos);
+        TranspositionTable tt(4);
+        SearchLimits limits;
+        limits.depth = 5;
+        limits.threads = threads;
+        SearchResult r = search(pos, defaultStateStack(), tt, limits);
+        assert(saveFEN(pos) == before && defaultStateStack().moves.empty());
+        assert(r.has_move && r.depth == 5 && is_legal(kiwipete, r.best_move));
+        assert((int)r.thread_nodes.size() == threads);
+        std::uint64_t sum = 0;
+        for (std::uint64_t n : r.thread_nodes) sum += n;
+        assert(sum == r.nodes);
+    }
+
+    // Every thread count finds the same forced mate.
+    for (int threads : {2, 4}) {
+        Position pos;
+        loadFEN(pos, "k7/8/1K6/8/8/8/8/1R6 w - - 0 1");
+        SearchLimits limits;
+        limits.depth = 6;
+        limits.threads = threads;
+        TranspositionTable tt(1);
+        SearchResult r = search(pos, defaultStateStack(), tt, limits);
+        assert(r.score == MATE_SCORE - 3);
+    }
+
+    // The node budget covers all threads, give or take one check interval each.
+    Position pos;
+    loadFEN(pos, kiwipete);
+    SearchLimits budget;
+    budget.nodes = 20000;
+    budget.threads = 4;
+    TranspositionTable tt(1);
+    SearchResult r = search(pos, defaultStateStack(), tt, budget);
+    assert(r.stopped && r.has_move && is_legal(kiwipete, r.best_move));
+    assert(r.nodes <= budget.nodes + 4 * 1024);
+
+    std::cout << "search_smp passed\n";
+    return 0;
+}
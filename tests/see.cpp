@@ -0,0 +1,74 @@
+#include <cassert>
+#include <iostream>
+#include <string>
+#include "chess/position.hpp"
+#include "chess/move.hpp"
+#include "chess/movegen.hpp"
+#include "chess/attacks.hpp"
+#include "chess/see.hpp"
+#include "chess/fen.hpp"
+#include "chess/cli.hpp"
+
+static Move find_move(const Position& pos, const std::string& uci) {
+    MoveList legal;
+    generateLegalMoves(pos, legal);
+    for (const Move& m : legal)
+        if (move_to_uci(m) == uci) return m;
+    assert(false && "move not legal");
+    return Move{};
+}
+
+static int see_of(const char* fen, const char* uci) {
+    Position pos;
+    bool ok = loadFEN(pos, fen);
+    assert(ok);
+    (void)ok;
+    return see(pos, find_move(pos, uci));
+}
+
+int main() {
+    // Undefended pawn.
+    assert(see_of("1k1r4/1pp4p/p7/4p3/8/P5P1/1PP4P/2K1R3 w - - 0 1", "e1e5") == 100);
+    // Knight for a pawn after the knight recapture; nothing better later.
+    assert(see_of("1k1r3q/1ppn3p/p4b2/4p3/8/P2N2P1/1PP1R1BP/2K1Q3 w - - 0 1", "d3e5") == 100 - 320);
+    // Rook for a defended pawn, then the second rook wins the pawn back
+    // through the first one's square (white x-ray).
+    assert(see_of("4k3/8/4p3/3p4/8/8/3R4/3RK3 w - - 0 1", "d2d5") == 100 - 500 + 100);
+    // Black's doubled rooks defend twice (black x-ray): -400 either way.
+    assert(see_of("3rk3/3r4/8/3p4/8/8/3R4/3RK3 w - - 0 1", "d2d5") == 100 - 500);
+    // Queen behind a bishop on the diagonal joins in once the bishop goes.
+    assert(see_of("4k3/8/2n5/8/4B3/5Q2/8/4K3 w - - 0 1", "e4c6") == 320);
+    assert(see_of("4k3/1p6/2n5/8/4B3/5Q2/8/4K3 w - - 0 1", "e4c6") == 320 - 330 + 100);
+    // En passant, promotion, and a promotion that is taken straight away.
+    assert(see_of("4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 1", "e5d6") == 100);
+    assert(see_of("4k3/P7/8/8/8/8/8/4K3 w - - 0 1", "a7a8q") == 800);
+    assert(see_of("r3k3/1P6/8/8/8/8/8/4K3 w - - 0 1", "b7b8q") == 800 - 900);
+    // Quiet moves onto a safe and a pawn-guarded square, and a king capture.
+    assert(see_of("4k3/8/3p4/8/8/8/8/2N1K3 w - - 0 1", "c1b3") == 0);
+    assert(see_of("4k3/8/3p4/8/8/1N6/8/4K3 w - - 0 1", "b3c5") == -320);
+    assert(see_of("8/8/8/8/8/8/4p3/4K2k w - - 0 1", "e1e2") == 100);
+
+    // attackersTo sees both colours, and x-rays appear as occupancy shrinks.
+    Position pos;
+    bool ok = loadFEN(pos, "3rk3/3r4/8/3p4/8/8/3R4/3RK3 w - - 0 1");
+    assert(ok);
+    int d5 = get_index('d', 5);
+    Bitboard att = attackersTo(d5, pos.total_pieces, pos);
+    assert(att == (convert_to_bit(get_index('d', 7)) | convert_to_bit(get_index('d', 2))));
+    Bitboard lifted = pos.total_pieces & ~convert_to_bit(get_index('d', 2)) & ~convert_to_bit(get_index('d', 7));
+    att = attackersTo(d5, lifted, pos) & lifted;
+    assert(att == (convert_to_bit(get_index('d', 8)) | convert_to_bit(get_index('d', 1))));
+
+    // Agrees with isPieceAttacked on every square of a busy position.
+    ok = loadFEN(pos, "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    assert(ok);
+    (void)ok;
+    for (int sq = 0; sq < 64; sq++) {
+        Bitboard a = attackersTo(sq, pos.total_pieces, pos);
+        assert(((a & pos.white_pieces) != 0) == isPieceAttacked(sq, WHITE, pos));
+        assert(((a & pos.black_pieces) != 0) == isPieceAttacked(sq, BLACK, pos));
+    }
+
+    std::cout << "see passed\n";
+    return 0;
+}
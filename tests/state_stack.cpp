@@ -0,0 +1,89 @@
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include "chess/position.hpp"
+#include "chess/move.hpp"
+#include "chess/movegen.hpp"
+#include "chess/make_undo.hpp"
+#include "chess/repetition.hpp"
+#include "chess/fen.hpp"
+#include "chess/cli.hpp"
+
+static uint64_t perft(Position& pos, StateStack& state, int depth) {
+    MoveList moves;
+    generateLegalMoves(pos, moves);
+    if (depth == 1) return moves.size();
+
+    uint64_t nodes = 0;
+    for (const auto& m : moves) {
+        makeMove(pos, m, state);
+        nodes += perft(pos, state, depth - 1);
+        UndoMove(pos, state);
+    }
+    return nodes;
+}
+
+static void play(Position& pos, StateStack& state, const char* uci) {
+    MoveList legal;
+    generateLegalMoves(pos, legal);
+    Move typed = convert_command(pos, std::string(uci));
+    for (const auto& m : legal) {
+        if (m == typed) {
+            makeMove(pos, m, state);
+            return;
+        }
+    }
+    assert(false && "move not legal");
+}
+
+int main() {
+    // Two games in one thread, each with its own stack.
+    Position a, b;
+    a.start_position();
+    b.start_position();
+    StateStack sa, sb;
+    sa.reset(a);
+    sb.reset(b);
+    std::string start = saveFEN(a);
+
+    const char* shuffle[] = {"g1f3", "g8f6", "f3g1", "f6g8"};
+    for (int round = 0; round < 2; ++round)
+        for (const char* mv : shuffle)
+            play(a, sa, mv);
+    play(b, sb, "e2e4");
+
+    // a is back at the start for the third time, b is not.
+    assert(is_threefold(a, sa));
+    assert(!is_threefold(b, sb));
+    assert(sa.moves.size() == 8 && sa.keys.size() == 9);
+    assert(sb.moves.size() == 1);
+
+    UndoMove(b, sb);
+    assert(saveFEN(b) == start);
+    while (!sa.moves.empty())
+        UndoMove(a, sa);
+    assert(saveFEN(a) == start);
+
+    // Independent perfts on separate threads, each with its own position and stack.
+    uint64_t kiwipete = 0, endgame = 0;
+    std::thread t1([&kiwipete] {
+        Position p;
+        loadFEN(p, "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+        StateStack s;
+        s.reset(p);
+        kiwipete = perft(p, s, 3);
+    });
+    std::thread t2([&endgame] {
+        Position p;
+        loadFEN(p, "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1");
+        StateStack s;
+        s.reset(p);
+        endgame = perft(p, s, 4);
+    });
+    t1.join();
+    t2.join();
+    assert(kiwipete == 97862ULL);
+    assert(endgame == 43238ULL);
+    return 0;
+}
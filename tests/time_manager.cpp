@@ -0,0 +1,93 @@
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include "chess/position.hpp"
+#include "chess/move.hpp"
+#include "chess/search.hpp"
+#include "chess/timeman.hpp"
+#include "chess/tt.hpp"
+#include "chess/fen.hpp"
+
+static TimeControl clock_of(std::int64_t time_ms, std::int64_t inc_ms = 0, int moves_to_go = 0) {
+    TimeControl tc;
+    tc.time_ms = time_ms;
+    tc.inc_ms = inc_ms;
+    tc.moves_to_go = moves_to_go;
+    return tc;
+}
+
+// Feeds iterations whose node counts double each time, at a simulated
+// 1M nodes per second, until the manager says stop. best(i) and score(i)
+// give iteration i's result. Returns how many iterations ran.
+template <typename Best, typename Score>
+static int iterations_until_stop(const TimeControl& tc, Best best, Score score) {
+    TimeManager tm(tc);
+    tm.simulate(1e6);
+    std::uint64_t nodes = 0;
+    for (int i = 1; i <= 40; i++) {
+        nodes += 1000ULL << i;
+        PackedMove m;
+        m.data = static_cast<std::uint16_t>(best(i));
+        if (tm.iterationDone(m, score(i), nodes)) {
+            // It never plans past the hard limit.
+            assert(tm.elapsedMs(nodes) <= static_cast<double>(tm.maximumMs()));
+            return i;
+        }
+    }
+    return 41;
+}
+
+static SearchResult timed_search(const char* fen, const TimeControl& tc, double nps, TranspositionTable& tt) {
+    Position pos;
+    bool ok = loadFEN(pos, fen);
+    assert(ok);
+    (void)ok;
+    TimeManager tm(tc);
+    tm.simulate(nps);
+    SearchLimits limits;
+    limits.time = &tm;
+    tt.clear();
+    SearchResult r = search(pos, defaultStateStack(), tt, limits);
+    // The hard limit is checked every 1024 nodes per thread.
+    assert(tm.elapsedMs(r.nodes) <= static_cast<double>(tm.maximumMs()) + 1024 * 1000.0 / nps);
+    return r;
+}
+
+int main() {
+    // Allocation: a share of the clock, never all of it.
+    TimeManager sudden(clock_of(60000));
+    assert(sudden.optimumMs() > 1000 && sudden.optimumMs() < 3000);
+    assert(sudden.maximumMs() > sudden.optimumMs() && sudden.maximumMs() <= 60000 * 4 / 5);
+    TimeManager with_inc(clock_of(60000, 1000));
+    assert(with_inc.optimumMs() > sudden.optimumMs());
+    TimeManager last_move(clock_of(1000, 0, 1));
+    assert(last_move.maximumMs() < 1000 - 30 && last_move.optimumMs() <= last_move.maximumMs());
+    TimeManager flagging(clock_of(10));
+    assert(flagging.optimumMs() >= 1 && flagging.maximumMs() >= 1);
+
+    // A best move that holds lets the search stop early; one that keeps
+    // changing, or a score that keeps dropping, buys more time.
+    TimeControl tc = clock_of(60000);
+    int stable = iterations_until_stop(tc, [](int) { return 1; }, [](int) { return 20; });
+    int unstable = iterations_until_stop(tc, [](int i) { return i; }, [](int) { return 20; });
+    int failing = iterations_until_stop(tc, [](int) { return 1; }, [](int i) { return 200 - 40 * i; });
+    assert(stable < unstable && stable < failing);
+    (void)stable, (void)unstable, (void)failing;
+
+    // Real searches on the simulated clock: inside the hard limit, and the
+    // same result every run.
+    TranspositionTable tt(16);
+    const char* kiwipete = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
+    SearchResult a = timed_search(kiwipete, clock_of(10000, 100), 1e6, tt);
+    SearchResult b = timed_search(kiwipete, clock_of(10000, 100), 1e6, tt);
+    assert(a.has_move && a.nodes == b.nodes && a.best_move == b.best_move && a.depth == b.depth);
+    // Less time, fewer nodes.
+    SearchResult c = timed_search(kiwipete, clock_of(1000), 1e6, tt);
+    assert(c.has_move && c.nodes < a.nodes);
+    // So little that the hard limit cuts an iteration short.
+    SearchResult d = timed_search(kiwipete, clock_of(60), 1e6, tt);
+    assert(d.has_move && d.nodes <= c.nodes);
+
+    std::cout << "time_manager passed\n";
+    return 0;
+}
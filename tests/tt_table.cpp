@@ -0,0 +1,77 @@
+#include <cassert>
+#include <cstdint>
+#include <iostream>
+#include "chess/tt.hpp"
+#include "chess/search.hpp"
+#include "chess/position.hpp"
+#include "chess/fen.hpp"
+
+int main() {
+    TranspositionTable tt(1);
+    assert(tt.sizeBytes() == (1u << 20));
+    const std::uint64_t buckets = tt.sizeBytes() / 64;
+
+    // Round trip, including negative scores and a missing key.
+    PackedMove m{0x1234};
+    tt.newSearch();
+    tt.store(42, m, -317, 9, BOUND_LOWER);
+    TTData d;
+    assert(tt.probe(42, d));
+    assert(d.move.data == m.data && d.score == -317 && d.depth == 9 && d.bound == BOUND_LOWER);
+    assert(!tt.probe(43, d));
+
+    // Same key without a move keeps the old move; a much shallower bound
+    // from the same search does not replace a deeper entry.
+    tt.store(42, PackedMove{}, 50, 10, BOUND_EXACT);
+    assert(tt.probe(42, d) && d.move.data == m.data && d.score == 50 && d.depth == 10);
+    tt.store(42, PackedMove{}, 7, 3, BOUND_UPPER);
+    assert(tt.probe(42, d) && d.depth == 10 && d.bound == BOUND_EXACT);
+
+    // Five keys in one four-entry bucket: the shallowest goes.
+    const std::uint64_t base = 7;
+    for (int i = 0; i < 4; i++)
+        tt.store(base + i * buckets, PackedMove{}, i, 10 + i, BOUND_EXACT);
+    tt.store(base + 4 * buckets, PackedMove{}, 4, 5, BOUND_EXACT);
+    assert(!tt.probe(base, d));
+    for (int i = 1; i <= 4; i++)
+        assert(tt.probe(base + i * buckets, d) && d.score == i);
+
+    // A generation of age costs 8 plies: depth-11 entries from the last
+    // search now go before depth-6 entries from this one.
+    tt.newSearch();
+    tt.store(base + 5 * buckets, PackedMove{}, 5, 6, BOUND_EXACT);
+    tt.store(base + 6 * buckets, PackedMove{}, 6, 6, BOUND_EXACT);
+    assert(tt.probe(base + 5 * buckets, d) && tt.probe(base + 6 * buckets, d));
+    assert(!tt.probe(base + 1 * buckets, d) && tt.probe(base + 2 * buckets, d));
+
+    // Only entries of the current generation count towards hashfull.
+    assert(tt.hashfull() < 5);
+    for (std::uint64_t k = 0; k < buckets * 4; k++)
+        tt.store(k * 0x9E3779B97F4A7C15ULL, PackedMove{}, 0, 1, BOUND_EXACT);
+    assert(tt.hashfull() > 500);
+    tt.clear();
+    assert(tt.hashfull() == 0 && !tt.probe(42, d));
+
+    // Mate scores are stored relative to the node.
+    int mate_in_3 = MATE_SCORE - 5;
+    assert(scoreFromTT(scoreToTT(mate_in_3, 2), 2) == mate_in_3);
+    assert(scoreToTT(mate_in_3, 2) == MATE_SCORE - 3);
+    assert(scoreFromTT(scoreToTT(-mate_in_3, 4), 1) == -(MATE_SCORE - 2));
+    assert(scoreToTT(123, 10) == 123);
+
+    // A search fills the table and reuses it: the second run of the same
+    // position hits much more and needs fewer nodes.
+    Position pos;
+    loadFEN(pos, "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    TranspositionTable search_tt(4);
+    SearchLimits limits;
+    limits.depth = 5;
+    SearchResult cold = search(pos, defaultStateStack(), search_tt, limits);
+    SearchResult warm = search(pos, defaultStateStack(), search_tt, limits);
+    assert(cold.tt_probes > 0 && cold.hashfull > 0);
+    assert(warm.nodes < cold.nodes && warm.ttHitRate() > cold.ttHitRate());
+    assert(warm.score == cold.score);
+
+    std::cout << "tt_table passed\n";
+    return 0;
+}
@@ -0,0 +1,112 @@
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include "chess/position.hpp"
+#include "chess/make_undo.hpp"
+#include "chess/perft.hpp"
+#include "chess/uci.hpp"
+#include "chess/fen.hpp"
+
+static bool contains(const std::string& text, const std::string& part) {
+    return text.find(part) != std::string::npos;
+}
+
+static int count(const std::string& text, const std::string& part) {
+    int n = 0;
+    for (std::size_t at = text.find(part); at != std::string::npos; at = text.find(part, at + 1)) n++;
+    return n;
+}
+
+// Runs the commands one by one, waits for any search they started, and
+// returns everything the engine printed.
+static std::string run(UciEngine& engine, std::ostringstream& out, const char* const* commands, int n) {
+    out.str("");
+    for (int i = 0; i < n; i++) {
+        bool more = engine.command(commands[i]);
+        assert(more);
+        (void)more;
+    }
+    engine.wait();
+    return out.str();
+}
+
+int main() {
+    std::ostringstream out;
+    UciEngine engine(out);
+
+    const char* handshake[] = {"uci", "isready"};
+    std::string text = run(engine, out, handshake, 2);
+    assert(contains(text, "id name") && contains(text, "option name Hash type spin"));
+    assert(contains(text, "option name Threads type spin") && contains(text, "uciok\n"));
+    assert(contains(text, "readyok\n"));
+
+    // go perft divides the position set up by "position ... moves".
+    const char* perft_cmds[] = {"position startpos moves e2e4 e7e5", "go perft 3"};
+    text = run(engine, out, perft_cmds, 2);
+    Position pos;
+    bool ok = loadFEN(pos, "rnbqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQKBNR w KQkq e6 0 2");
+    assert(ok);
+    (void)ok;
+    assert(contains(text, "Nodes searched: " + std::to_string(perft(pos, 3)) + "\n"));
+    assert(contains(text, "g1f3: "));
+
+    // A mate in one, from a FEN with moves played on top of it.
+    const char* mate[] = {"ucinewgame", "position fen 6k1/5ppp/8/8/8/8/5PPP/R5K1 b - - 0 1 moves g8h8",
+                          "go depth 3"};
+    text = run(engine, out, mate, 3);
+    assert(contains(text, "info depth 1 ") && contains(text, "score mate 1"));
+    assert(contains(text, "bestmove a1a8"));
+
+    // Illegal moves are reported and leave the position before them.
+    const char* illegal[] = {"position startpos moves e2e5", "go perft 1"};
+    text = run(engine, out, illegal, 2);
+    assert(contains(text, "info string illegal move e2e5"));
+    assert(contains(text, "Nodes searched: 20\n"));
+
+    // Option names are not case sensitive.
+    const char* options[] = {"setoption name hash value 1", "setoption name THREADS value 2",
+                             "setoption name Move Overhead value 10", "setoption name NoSuchOption value 1"};
+    text = run(engine, out, options, 4);
+    assert(count(text, "unknown option") == 1 && contains(text, "unknown option NoSuchOption"));
+
+    // Clock-based and node-limited searches end by themselves, also with a
+    // clock already at or below zero, as a lagging GUI sends it. The bound is
+    // only there to fail rather than hang; the clock is two seconds.
+    const char* clock[] = {"position startpos", "go wtime 2000 btime 2000 winc 10 binc 10"};
+    auto start = std::chrono::steady_clock::now();
+    text = run(engine, out, clock, 2);
+    assert(count(text, "bestmove ") == 1);
+    const char* flagged[] = {"go wtime -50 btime 1000"};
+    text = run(engine, out, flagged, 1);
+    assert(count(text, "bestmove ") == 1);
+    const char* nodes[] = {"go nodes 20000"};
+    text = run(engine, out, nodes, 1);
+    assert(count(text, "bestmove ") == 1);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    assert(seconds < 60.0);
+    (void)seconds;
+
+    // An infinite search answers isready while it runs and holds its
+    // bestmove until stop, which prints exactly one.
+    out.str("");
+    ok = engine.command("go infinite");
+    assert(ok);
+    ok = engine.command("isready");
+    assert(ok);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    text = out.str();
+    assert(contains(text, "readyok") && count(text, "bestmove ") == 0);
+    ok = engine.command("stop");
+    assert(ok);
+    text = out.str();
+    assert(count(text, "bestmove ") == 1 && text.find("readyok") < text.find("bestmove "));
+
+    ok = engine.command("quit");
+    assert(!ok);
+    std::cout << "uci_protocol passed\n";
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include <cassert>
+#include <cstdint>
+#include "chess/position.hpp"
+#include "chess/move.hpp"
+#include "chess/movegen.hpp"
+#include "chess/make_undo.hpp"
+#include "chess/zobrist.hpp"
+#include "chess/fen.hpp"
+#include <string>
+
+// Perft that checks the incremental keys (full and pawn-only) against a
+// full recompute after every makeMove and every UndoMove.
+static uint64_t perft_checked(Position& pos, int depth) {
+    MoveList moves;
+    generateLegalAllMoves(pos, moves);
+    if (depth == 0) return 1;
+
+    uint64_t nodes = 0;
+    for (const auto& m : moves) {
+        std::uint64_t before = pos.zobrist;
+        std::uint64_t pawns_before = pos.pawn_key;
+        makeMove(pos, m);
+        assert(pos.zobrist == Zobrist::compute(pos));
+        assert(pos.pawn_key == Zobrist::computePawnKey(pos));
+        nodes += perft_checked(pos, depth - 1);
+        UndoMove(pos);
+        assert(pos.zobrist == before && pos.pawn_key == pawns_before);
+        assert(pos.zobrist == Zobrist::compute(pos));
+    }
+    return nodes;
+}
+
+int main() {
+    Position p;
+    bool ok = loadFEN(p, "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1");
+    assert(ok);
+    // Keys must be initialised for FEN-loaded positions too.
+    assert(p.zobrist != 0);
+    assert(perft_checked(p, 3) == 97862ULL);
+
+    ok = loadFEN(p, "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1");
+    assert(ok);
+    assert(perft_checked(p, 3) == 9467ULL);
+
+    ok = loadFEN(p, "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1");
+    assert(ok);
+    assert(perft_checked(p, 4) == 43238ULL);
+
+    // Null move: the en passant square goes, the side flips, and the key
+    // follows both; undo puts everything back.
+    ok = loadFEN(p, "4k3/8/8/3pP3/8/8/8/4K3 w - d6 0 5");
+    assert(ok);
+    std::string before = saveFEN(p);
+    std::uint64_t key = p.zobrist;
+    StateStack state;
+    state.reset(p);
+    makeNullMove(p, state);
+    assert(p.side_to_move == BLACK && p.en_passant == -1);
+    assert(p.zobrist == Zobrist::compute(p) && p.zobrist != key);
+    assert(state.keys.back() == p.zobrist && state.moves.size() == 1);
+    makeNullMove(p, state);
+    assert(p.zobrist == Zobrist::compute(p) && p.fullmove == 6);
+    undoNullMove(p, state);
+    undoNullMove(p, state);
+    assert(saveFEN(p) == before && p.zobrist == key);
+    assert(state.moves.empty() && state.keys.size() == 1);
+    return 0;
+}
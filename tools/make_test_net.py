@@ -0,0 +1,78 @@
+#!/usr/bin/env python3
+"""Writes assets/test.nnue, the small network the tests and benchmarks use.
+
+It is not trained. Five accumulator values per perspective count that
+side's pawns, knights, bishops, rooks and queens, and the hidden and output
+layers turn the two sides' counts into a material balance close to the
+usual 100/320/330/500/900. The remaining values get small pseudo-random
+weights for every feature, so each piece, square and king bucket moves the
+accumulator differently (which is what the incremental-update tests need)
+while adding only a few centipawns of noise to the score.
+
+Layout: see include/chess/nnue.hpp. Usage: make_test_net.py [output path]
+"""
+import random
+import struct
+import sys
+
+KING_BUCKETS, ACC, HIDDEN = 4, 32, 16
+FEATURES = KING_BUCKETS * 12 * 64
+INPUT = 2 * ACC
+
+# Per piece type (our pawn .. queen): accumulator units per piece and the
+# output weight, chosen so units * weight / 16 is the piece value and a
+# normal amount of material stays below the clip at 127.
+UNITS = [14, 42, 42, 63, 120]
+OUT_WEIGHT = [114, 122, 126, 127, 120]
+NOISE_BIAS = 40
+
+
+def pad(data):
+    return data + b"\0" * (-len(data) % 64)
+
+
+def main():
+    out_path = sys.argv[1] if len(sys.argv) > 1 else "assets/test.nnue"
+    rng = random.Random(20240517)
+
+    ft_bias = [0] * 5 + [NOISE_BIAS] * (ACC - 5)
+    ft_weights = []
+    for feature in range(FEATURES):
+        rel_piece = feature // 64 % 12
+        row = [0] * ACC
+        if rel_piece < 5:  # one of our own non-king pieces
+            row[rel_piece] = UNITS[rel_piece]
+        for i in range(5, ACC):
+            row[i] = rng.randint(-4, 4)
+        ft_weights += row
+
+    hidden_bias, hidden_weights = [], []
+    for j in range(HIDDEN):
+        row = [0] * INPUT
+        if j < 10:  # material: pass the count through unchanged
+            row[(j // 5) * ACC + j % 5] = 1 << 6
+            hidden_bias.append(0)
+        else:  # noise, centred on 64 after the shift
+            for half in range(2):
+                for i in range(5, ACC):
+                    row[half * ACC + i] = rng.randint(-8, 8)
+            hidden_bias.append((64 << 6) - NOISE_BIAS * sum(row))
+        hidden_weights += row
+
+    output_weights = OUT_WEIGHT + [-w for w in OUT_WEIGHT]
+    output_weights += [rng.choice([-2, -1, 1, 2]) for _ in range(HIDDEN - 10)]
+    output_bias = -64 * sum(output_weights[10:])
+
+    data = pad(b"CNUE" + struct.pack("<4I", 1, FEATURES, ACC, HIDDEN))
+    data += pad(struct.pack("<%dh" % ACC, *ft_bias))
+    data += pad(struct.pack("<%dh" % len(ft_weights), *ft_weights))
+    data += pad(struct.pack("<%di" % HIDDEN, *hidden_bias))
+    data += pad(struct.pack("<%db" % len(hidden_weights), *hidden_weights))
+    data += pad(struct.pack("<i", output_bias))
+    data += pad(struct.pack("<%db" % HIDDEN, *output_weights))
+    with open(out_path, "wb") as f:
+        f.write(data)
+
+
+if __name__ == "__main__":
+    main()